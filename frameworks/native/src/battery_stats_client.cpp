@@ -90,6 +90,22 @@ BatteryStatsInfoList BatteryStatsClient::GetBatteryStats()
     return parcelableEntityList.statsList_;
 }
 
+BatteryStatsInfoList BatteryStatsClient::GetTopConsumers(int32_t count)
+{
+    STATS_HILOGD(COMP_FWK, "Call GetTopConsumers");
+    BatteryStatsInfoList entityList;
+    if (Connect() != ERR_OK) {
+        lastError_ = StatsError::ERR_CONNECTION_FAIL;
+        return entityList;
+    }
+
+    ParcelableBatteryStatsList parcelableEntityList;
+    int32_t tempError = INIT_VALUE;
+    proxy_->GetTopConsumersIpc(count, parcelableEntityList, tempError);
+    tempError_ = static_cast<StatsError>(tempError);
+    return parcelableEntityList.statsList_;
+}
+
 double BatteryStatsClient::GetAppStatsMah(const int32_t& uid)
 {
     STATS_HILOGD(COMP_FWK, "Call GetAppStatsMah");
@@ -153,6 +169,49 @@ double BatteryStatsClient::GetPartStatsPercent(const BatteryStatsInfo::Consumpti
     return partStatsPercent;
 }
 
+double BatteryStatsClient::GetHistoryStatsMah(const BatteryStatsInfo::ConsumptionType& type, int32_t uid,
+    int64_t beginTimeMs, int64_t endTimeMs)
+{
+    STATS_HILOGD(COMP_FWK, "Call GetHistoryStatsMah");
+    double historyStatsMah = StatsUtils::DEFAULT_VALUE;
+    if (Connect() != ERR_OK) {
+        lastError_ = StatsError::ERR_CONNECTION_FAIL;
+        return historyStatsMah;
+    }
+    int32_t tempError = INIT_VALUE;
+    proxy_->GetHistoryStatsMahIpc(static_cast<int32_t>(type), uid, beginTimeMs, endTimeMs, historyStatsMah,
+        tempError);
+    tempError_ = static_cast<StatsError>(tempError);
+    return historyStatsMah;
+}
+
+void BatteryStatsClient::MarkLedger(const std::string& name)
+{
+    STATS_HILOGD(COMP_FWK, "Call MarkLedger");
+    if (Connect() != ERR_OK) {
+        lastError_ = StatsError::ERR_CONNECTION_FAIL;
+        return;
+    }
+    int32_t tempError = INIT_VALUE;
+    proxy_->MarkLedgerIpc(name, tempError);
+    tempError_ = static_cast<StatsError>(tempError);
+}
+
+double BatteryStatsClient::GetLedgerStatsMah(const std::string& name, const BatteryStatsInfo::ConsumptionType& type,
+    int32_t uid)
+{
+    STATS_HILOGD(COMP_FWK, "Call GetLedgerStatsMah");
+    double ledgerStatsMah = StatsUtils::DEFAULT_VALUE;
+    if (Connect() != ERR_OK) {
+        lastError_ = StatsError::ERR_CONNECTION_FAIL;
+        return ledgerStatsMah;
+    }
+    int32_t tempError = INIT_VALUE;
+    proxy_->GetLedgerStatsMahIpc(name, static_cast<int32_t>(type), uid, ledgerStatsMah, tempError);
+    tempError_ = static_cast<StatsError>(tempError);
+    return ledgerStatsMah;
+}
+
 void BatteryStatsClient::Reset()
 {
     STATS_HILOGD(COMP_FWK, "Call Reset");
@@ -36,6 +36,11 @@ class BatteryStatsClient final : public DelayedRefSingleton<BatteryStatsClient>
 public:
     DISALLOW_COPY_AND_MOVE(BatteryStatsClient);
     BatteryStatsInfoList GetBatteryStats();
+    /**
+     * The apps with the highest power consumption in descending order, at most 32 of them, as of the last
+     * power calculation.
+     */
+    BatteryStatsInfoList GetTopConsumers(int32_t count);
     void SetOnBattery(bool isOnBattery);
     double GetAppStatsMah(const int32_t& uid);
     double GetAppStatsPercent(const int32_t& uid);
@@ -44,6 +49,22 @@ public:
     uint64_t GetTotalTimeSecond(const StatsUtils::StatsType& statsType, const int32_t& uid = StatsUtils::INVALID_VALUE);
     uint64_t GetTotalDataBytes(const StatsUtils::StatsType& statsType, const int32_t& uid = StatsUtils::INVALID_VALUE);
     void Reset();
+    /**
+     * Power consumed in the boot time range [beginTimeMs, endTimeMs] within the last 24 hours, in 5-minute
+     * resolution. Pass CONSUMPTION_TYPE_APP with a uid for a single app.
+     */
+    double GetHistoryStatsMah(const BatteryStatsInfo::ConsumptionType& type, int32_t uid, int64_t beginTimeMs,
+        int64_t endTimeMs);
+    /**
+     * Start a custom accounting window, or restart it if it exists. "unplug" is restarted by the service on
+     * every unplug, "boot" and "reset" can't be marked.
+     */
+    void MarkLedger(const std::string& name);
+    /**
+     * Power consumed since the marker of a window, "boot", "reset", "unplug" or a custom one.
+     */
+    double GetLedgerStatsMah(const std::string& name, const BatteryStatsInfo::ConsumptionType& type,
+        int32_t uid = StatsUtils::INVALID_VALUE);
     std::string Dump(const std::vector<std::string>& args);
     StatsError GetLastError();
 
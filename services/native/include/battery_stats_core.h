@@ -16,6 +16,8 @@
 #ifndef BATTERY_STATS_CORE_H
 #define BATTERY_STATS_CORE_H
 
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -26,6 +28,14 @@
 
 #include "battery_stats_info.h"
 #include "entities/battery_stats_entity.h"
+#include "entities/screen_entity.h"
+#include "entities/wakelock_entity.h"
+#include "stats_activation_table.h"
+#include "stats_arena.h"
+#include "stats_cpu_sampler.h"
+#include "stats_history.h"
+#include "stats_ledger.h"
+#include "stats_top_consumers.h"
 #include "stats_log.h"
 #include "stats_utils.h"
 
@@ -51,9 +61,17 @@ public:
     int64_t GetTotalConsumptionCount(StatsUtils::StatsType statsType, int32_t uid = StatsUtils::INVALID_VALUE);
     void UpdateStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state,
         int16_t level = StatsUtils::INVALID_VALUE, int32_t uid = StatsUtils::INVALID_VALUE,
-        const std::string& deviceId = "");
+        const std::string& deviceId = "", int32_t pid = StatsUtils::INVALID_VALUE);
     void UpdateStats(StatsUtils::StatsType statsType, int64_t time, int64_t data,
         int32_t uid = StatsUtils::INVALID_VALUE);
+    void UpdateWakelockStats(StatsUtils::StatsState state, int32_t uid, const std::string& name,
+        int32_t pid = StatsUtils::INVALID_VALUE);
+    std::vector<WakelockHoldTime> GetTopWakelocks(size_t count);
+    void GetWakelockHoldTimesMs(std::vector<int64_t>& holdTimesMs);
+    void SetAccountingMode(StatsTimerStore::AccountingMode mode);
+    void SetCpuParallelRead(bool parallelRead);
+    void SetOnBattery(bool isOnBattery);
+    std::shared_ptr<StatsCpuSampler> GetCpuSampler();
     std::shared_ptr<BatteryStatsEntity> GetEntity(const BatteryStatsInfo::ConsumptionType& type);
     bool SaveBatteryStatsData();
     bool LoadBatteryStatsData();
@@ -62,6 +80,14 @@ public:
     void GetDebugInfo(std::string& result);
     void Reset();
     bool Init();
+    std::shared_ptr<StatsArena> GetStatsArena();
+    double GetHistoryMah(const BatteryStatsInfo::ConsumptionType& type, int32_t uid, int64_t beginTimeMs,
+        int64_t endTimeMs);
+    std::shared_ptr<StatsTopConsumers> GetStatsTopConsumers();
+    BatteryStatsInfoList GetTopConsumers(int32_t count);
+    bool MarkLedger(const std::string& name);
+    bool GetLedgerMah(const std::string& name, const BatteryStatsInfo::ConsumptionType& type, int32_t uid,
+        double& powerMah);
 private:
     std::shared_ptr<BatteryStatsEntity> audioEntity_;
     std::shared_ptr<BatteryStatsEntity> bluetoothEntity_;
@@ -71,25 +97,51 @@ private:
     std::shared_ptr<BatteryStatsEntity> gnssEntity_;
     std::shared_ptr<BatteryStatsEntity> idleEntity_;
     std::shared_ptr<BatteryStatsEntity> phoneEntity_;
-    std::shared_ptr<BatteryStatsEntity> screenEntity_;
+    std::shared_ptr<ScreenEntity> screenEntity_;
     std::shared_ptr<BatteryStatsEntity> sensorEntity_;
     std::shared_ptr<BatteryStatsEntity> uidEntity_;
     std::shared_ptr<BatteryStatsEntity> userEntity_;
     std::shared_ptr<BatteryStatsEntity> wifiEntity_;
-    std::shared_ptr<BatteryStatsEntity> wakelockEntity_;
+    std::shared_ptr<WakelockEntity> wakelockEntity_;
     std::shared_ptr<BatteryStatsEntity> alarmEntity_;
-    bool isCameraOn_ = false;
+    std::shared_ptr<StatsArena> statsArena_ = std::make_shared<StatsArena>();
+    std::shared_ptr<StatsHistory> statsHistory_ = std::make_shared<StatsHistory>();
+    std::shared_ptr<StatsTopConsumers> topConsumers_ = std::make_shared<StatsTopConsumers>();
+    std::shared_ptr<StatsLedger> statsLedger_ = std::make_shared<StatsLedger>();
+    std::shared_ptr<StatsActivationTable> activations_ = std::make_shared<StatsActivationTable>();
     bool isScreenOn_ = false;
     int32_t lastBrightnessLevel_ = StatsUtils::INVALID_VALUE;
-    int32_t lastCameraUid_ = StatsUtils::INVALID_VALUE;
+    // Open camera sessions, one per device, and the slot of the latest one for flashlight events without a device
+    struct CameraSession {
+        std::string deviceId;
+        int32_t uid = StatsUtils::INVALID_VALUE;
+        bool isFlashlightOn = false;
+        // Since when the overlap with the other sessions of the uid is charged
+        int64_t overlapSinceMs = StatsUtils::DEFAULT_VALUE;
+    };
+    static constexpr int32_t MAX_CAMERA_SESSIONS = 8;
+    std::array<CameraSession, MAX_CAMERA_SESSIONS> cameraSessions_;
+    int32_t lastCameraSlot_ = StatsUtils::INVALID_VALUE;
     std::mutex mutex_;
     std::string debugInfo_;
+    // Set by a stop event past the end of the current history bucket, the bucket is closed after the next sample
+    std::atomic_bool isBucketCloseDue_ { false };
+    // Declared after the entities and the mutex, so its worker is joined before they are destroyed
+    std::shared_ptr<StatsCpuSampler> cpuSampler_ = std::make_shared<StatsCpuSampler>([this] { OnCpuSample(); });
     void UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, StatsUtils::StatsType statsType,
-        StatsUtils::StatsState state, int32_t uid = StatsUtils::INVALID_VALUE);
+        StatsUtils::StatsState state, int32_t uid = StatsUtils::INVALID_VALUE,
+        int32_t pid = StatsUtils::INVALID_VALUE);
     void UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, StatsUtils::StatsType statsType,
         int64_t time, int32_t uid = StatsUtils::INVALID_VALUE);
-    void UpdateCameraTimer(StatsUtils::StatsState state, int32_t uid, const std::string& deviceId);
+    int32_t FindCameraSession(const std::string& deviceId) const;
+    void OpenCameraSession(int32_t uid, const std::string& deviceId);
+    void CloseCameraSession(const std::string& deviceId);
+    void FoldCameraOverlap(int32_t uid);
+    void UpdateCameraFlashlight(StatsUtils::StatsState state, const std::string& deviceId);
     void UpdateScreenTimer(StatsUtils::StatsState state);
+    void UpdateCpuTime();
+    void OnCpuSample();
+    void CalculatePower();
     void UpdateBrightnessTimer(StatsUtils::StatsState state, int16_t level);
     void UpdateCounter(std::shared_ptr<BatteryStatsEntity> entity, StatsUtils::StatsType statsType,
         int64_t data, int32_t uid = StatsUtils::INVALID_VALUE);
@@ -97,8 +149,9 @@ private:
     void UpdateCameraStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid,
         const std::string& deviceId);
     void UpdatePhoneStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level);
-    void UpdateConnectivityStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid);
-    void UpdateCommonStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid);
+    void UpdateConnectivityStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid,
+        int32_t pid);
+    void UpdateCommonStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid, int32_t pid);
     void CreatePartEntity();
     void CreateAppEntity();
     void UpdateStatsEntity(cJSON* root);
@@ -39,15 +39,23 @@ public:
     double GetAveragePowerMa(std::string type, uint16_t level);
     uint16_t GetClusterNum();
     uint16_t GetSpeedNum(uint16_t cluster);
+    double GetCpuActiveCoefficientMa() const;
+    const std::vector<double>& GetCpuClusterCoefficientsMa() const;
+    const std::vector<double>& GetCpuSpeedCoefficientsMa() const;
     bool Init();
     void DumpInfo(std::string& result);
 private:
     bool LoadAveragePowerFromFile(const std::string& path);
     void ParsingArray(const std::string& type, const cJSON* array);
+    void BuildCpuCoefficients();
     std::map<std::string, double> averageMap_;
     std::map<std::string, std::vector<double>> averageVecMap_;
     uint16_t clusterNum_ = 0;
     std::vector<uint16_t> speedNum_;
+    // Cpu currents resolved once per profile, the speed currents laid out like a cpu freq time row
+    double cpuActiveCoefficientMa_ = 0.0;
+    std::vector<double> cpuClusterCoefficientsMa_;
+    std::vector<double> cpuSpeedCoefficientsMa_;
 };
 } // namespace PowerMgr
 } // namespace OHOS
@@ -54,6 +54,12 @@ public:
     int32_t GetTotalDataBytesIpc(int32_t statsType, int32_t uid, uint64_t& totalDataBytes) override;
     int32_t ResetIpc() override;
     int32_t ShellDumpIpc(const std::vector<std::string>& args, uint32_t argc, std::string& dumpShell) override;
+    int32_t GetHistoryStatsMahIpc(int32_t type, int32_t uid, int64_t beginTimeMs, int64_t endTimeMs,
+        double& historyStatsMah, int32_t& tempError) override;
+    int32_t MarkLedgerIpc(const std::string& name, int32_t& tempError) override;
+    int32_t GetLedgerStatsMahIpc(const std::string& name, int32_t type, int32_t uid, double& ledgerStatsMah,
+        int32_t& tempError) override;
+    int32_t GetTopConsumersIpc(int32_t count, ParcelableBatteryStatsList& topConsumers, int32_t& tempError) override;
 
     BatteryStatsInfoList GetBatteryStats();
     double GetAppStatsMah(const int32_t& uid);
@@ -65,6 +71,11 @@ public:
     void Reset();
     void SetOnBattery(bool isOnBattery);
     std::string ShellDump(const std::vector<std::string>& args, uint32_t argc);
+    double GetHistoryStatsMah(const BatteryStatsInfo::ConsumptionType& type, int32_t uid, int64_t beginTimeMs,
+        int64_t endTimeMs);
+    BatteryStatsInfoList GetTopConsumers(int32_t count);
+    void MarkLedger(const std::string& name);
+    double GetLedgerStatsMah(const std::string& name, const BatteryStatsInfo::ConsumptionType& type, int32_t uid);
     std::shared_ptr<BatteryStatsCore> GetBatteryStatsCore() const;
     std::shared_ptr<BatteryStatsParser> GetBatteryStatsParser() const;
     std::shared_ptr<BatteryStatsDetector> GetBatteryStatsDetector() const;
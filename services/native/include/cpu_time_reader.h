@@ -16,56 +16,177 @@
 #ifndef CPU_TIME_READER
 #define CPU_TIME_READER
 
-#include <map>
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "pid_cpu_time_reader.h"
+
 namespace OHOS {
 namespace PowerMgr {
+class BatteryStatsParser;
 class CpuTimeReader {
 public:
     CpuTimeReader() = default;
-    ~CpuTimeReader() = default;
+    ~CpuTimeReader();
+    CpuTimeReader(const CpuTimeReader&) = delete;
+    CpuTimeReader& operator=(const CpuTimeReader&) = delete;
     bool Init();
     int64_t GetUidCpuActiveTimeMs(int32_t uid);
+    int64_t GetUidCpuWeightedActiveTimeMs(int32_t uid);
     int64_t GetUidCpuClusterTimeMs(int32_t uid, uint32_t cluster);
+    int64_t GetUidCpuWeightedClusterTimeMs(int32_t uid, uint32_t cluster);
     int64_t GetUidCpuFreqTimeMs(int32_t uid, uint32_t cluster, uint32_t speed);
+    const int64_t* GetUidCpuFreqTimesMs(int32_t uid, uint32_t cluster, size_t& speedNum);
+    const int64_t* GetFreqTimeMatrix(size_t& rowCount, size_t& rowSize);
+    const int64_t* GetActiveTimeColumn(size_t& rowCount, bool isWeighted);
+    const std::vector<int64_t>* GetClusterTimeColumn(size_t& rowCount);
+    const std::vector<int64_t>* GetUidTimeColumn(size_t& rowCount);
     bool UpdateCpuTime();
     std::vector<int64_t> GetUidCpuTimeMs(int32_t uid);
     void DumpInfo(std::string& result, int32_t uid);
+    void DumpReadInfo(std::string& result);
+    void SetProcRoot(const std::string& procRoot);
+    void SetParallelRead(bool parallelRead);
 
 private:
+    class ProcScanner;
+    enum ProcFileId : uint32_t {
+        PROC_FILE_ACTIVE_TIME = 0,
+        PROC_FILE_CLUSTER_TIME,
+        PROC_FILE_FREQ_TIME,
+        PROC_FILE_UID_TIME,
+        PROC_FILE_COUNT,
+    };
+    // Every proc file stays open between samples and is re-read from offset 0, it is only reopened on error.
+    // Each file is staged into its own buffer, so the four reads of a sample may run on separate threads
+    struct ProcFile {
+        int32_t fd = -1;
+        uint32_t openCount = 0;
+        uint32_t errorCount = 0;
+        int64_t readTimeUs = 0;
+        size_t readBytes = 0;
+        bool isStaged = false;
+        std::vector<char> buffer;
+        // Start of every line of the buffer followed by its end, and the same of the sample before
+        std::vector<uint32_t> rowOffsets;
+        std::vector<char> lastBuffer;
+        std::vector<uint32_t> lastRowOffsets;
+        // Uid of every line of the buffer, StatsUtils::INVALID_VALUE for lines without one
+        std::vector<int32_t> rowUids;
+        // The uids rowIndexes were resolved for, rows only need a lookup once their uid differs
+        std::vector<int32_t> indexedRowUids;
+        std::vector<uint32_t> rowIndexes;
+    };
+    static constexpr size_t UID_TIME_COUNT = 2; // user and system time
+    using UidTime = std::array<int64_t, UID_TIME_COUNT>;
+    std::string procRoot_ = "/proc";
+    std::array<ProcFile, PROC_FILE_COUNT> procFiles_ {};
+    bool parallelRead_ = false;
+    // One worker per proc file but the first, started with the parallel read and kept between samples.
+    // The reading thread stages the first file itself and waits until the workers are done with theirs
+    std::vector<std::thread> stageWorkers_;
+    std::mutex stageMutex_;
+    std::condition_variable stageCond_;
+    std::condition_variable stagedCond_;
+    uint64_t stageSeq_ = 0;
+    uint32_t pendingStageCount_ = 0;
+    bool isStageStopping_ = false;
+    // Wall time of staging all proc files of the last sample, the longest single read when they run in parallel
+    int64_t readLatencyUs_ = 0;
+    // Rows whose uid changed in the last sample, interned together in one batch
+    std::vector<int32_t> newRowUids_;
+    std::vector<std::pair<uint32_t, size_t>> newRows_;
+    std::vector<uint32_t> newRowIndexes_;
+    // Uid rows merged in the last sample, and those of them equal to the sample before that were skipped
+    size_t uidRowCount_ = 0;
+    size_t unchangedRowCount_ = 0;
+    // Used while the uid active time or uid time file is missing, it then stands in for the missing one
+    PidCpuTimeReader pidReader_;
+    bool usePidActiveTime_ = false;
+    bool usePidUidTime_ = false;
     uint32_t wakelockCounts_ = 0;
-    std::map<int32_t, int64_t> activeTimeMap_;
-    std::map<int32_t, std::vector<int64_t>> clusterTimeMap_;
-    std::map<int32_t, std::map<uint32_t, std::vector<int64_t>>> freqTimeMap_;
-    std::map<int32_t, std::vector<int64_t>> uidTimeMap_;
-    std::map<int32_t, int64_t> lastActiveTimeMap_;
-    std::map<int32_t, std::vector<int64_t>> lastClusterTimeMap_;
-    std::map<int32_t, std::map<uint32_t, std::vector<int64_t>>> lastFreqTimeMap_;
-    std::map<int32_t, std::vector<int64_t>> lastUidTimeMap_;
-    std::map<uint16_t, uint16_t> clustersMap_;
+    // Wakelock hold time of every holder in the current sampling interval, as (uid index, time) pairs
+    std::vector<std::pair<uint32_t, int64_t>> wakelockHolders_;
+    int64_t wakelockHoldTimeMs_ = 0;
+    std::vector<int64_t> lastHoldTimesMs_;
+    // Time withheld from the running uids while wakelocks were held, flattened over cluster and speed
+    std::vector<int64_t> withheldFreqTimes_;
+    std::vector<int64_t> withheldUidTimes_;
+    // Per-uid entries are indexed by the dense uid index of StatsUidInterner, an empty entry means that
+    // nothing has been read for the uid yet
+    std::vector<int64_t> activeTimes_;
+    // Active time with every slice divided by the number of cpus active in it
+    std::vector<int64_t> weightedActiveTimes_;
+    // Time of every cluster, followed by the same weighted by the number of cores of the cluster active in it
+    std::vector<std::vector<int64_t>> clusterTimes_;
+    // Time per speed of every uid, one row per uid index laid out cluster after cluster at speedOffsets_
+    std::vector<int64_t> freqTimes_;
+    std::vector<std::vector<int64_t>> uidTimes_;
+    std::vector<int64_t> lastActiveTimes_;
+    std::vector<int64_t> lastWeightedActiveTimes_;
+    std::vector<std::vector<int64_t>> lastClusterTimes_;
+    std::vector<int64_t> lastFreqTimes_;
+    std::vector<uint8_t> hasFreqTime_;
+    std::vector<uint8_t> hasLastFreqTime_;
+    // Offset of every cluster in a frequency row, followed by the row length
+    std::vector<uint32_t> speedOffsets_ { 0 };
+    std::vector<std::vector<int64_t>> lastUidTimes_;
+    // Scratch buffers reused by every sample, so parsing allocates nothing once they have grown
+    std::vector<uint16_t> clusters_;
+    std::vector<int64_t> concurrencyTimes_;
+    // 1 / n for a slice with n cpus active, at index n - 1
+    std::vector<double> concurrencyWeights_;
+    std::vector<int64_t> clusterTime_;
+    std::vector<int64_t> clusterIncrements_;
+    std::vector<int64_t> freqTime_;
+    std::vector<int64_t> freqIncrements_;
+    std::vector<int64_t> freqUidIncrements_;
+    std::string GetProcFilePath(const std::string& name) const;
+    bool OpenProcFile(ProcFileId id);
+    void CloseProcFiles();
+    bool ReadProcFile(ProcFileId id, size_t& size);
+    bool StageProcFile(ProcFileId id);
+    bool ReadStagedProcFile(ProcFileId id);
+    void StageProcFiles();
+    void StartStageWorkers();
+    void StopStageWorkers();
+    void RunStageWorker(ProcFileId id, uint64_t stagedSeq);
+    bool OpenProcScanner(ProcFileId id, ProcScanner& scanner);
+    static void ScanRows(ProcFile& file);
+    void ResolveRowUids();
+    uint32_t GetRowUidIndex(ProcFileId id, size_t row) const;
+    bool IsRowUnchanged(ProcFileId id, size_t row);
+    uint32_t GetUidIndex(int32_t uid);
+    void EnsureUidIndex(uint32_t index);
+    size_t GetFreqRowSize() const;
+    void UpdateFreqLayout(const std::shared_ptr<BatteryStatsParser>& parser);
+    bool FindUidIndex(int32_t uid, uint32_t& index);
+    void UpdateWakelockHolders();
+    int64_t GetHolderShare(int64_t withheldTime, int64_t holdTimeBeforeMs, int64_t holdTimeMs) const;
+    void DistributeWithheldFreqTime();
+    void DistributeWithheldUidTime();
     bool ReadUidCpuActiveTime();
-    bool ReadUidCpuActiveTimeImpl(std::string& line, int32_t uid);
+    bool UpdateUidCpuActiveTime(int64_t timeMs, int64_t weightedTimeMs, uint32_t index);
+    void SumConcurrencyTimes(const int64_t* times, size_t count, int64_t& timeMs, int64_t& weightedTimeMs);
+    void ParseConcurrencyTimes(ProcScanner& scanner);
     bool ReadUidCpuClusterTime();
-    void AddIncrementsToClusterTime(std::vector<int64_t>& clusterTime,
-        const std::vector<int64_t>& increments, const std::vector<uint16_t>& clusters);
-    void ReadPolicy(std::vector<uint16_t>& clusters, std::string& line);
-    bool ReadClusterTimeIncrement(std::vector<int64_t>& clusterTime, std::vector<int64_t>& increments, int32_t uid,
-        std::vector<uint16_t>& clusters, std::string& timeLine);
+    void AddIncrementsToClusterTime(std::vector<int64_t>& clusterTime, const std::vector<int64_t>& increments);
+    void ReadPolicy(ProcScanner& scanner);
+    bool ReadClusterTimeIncrement(ProcScanner& scanner, uint32_t index);
     bool ReadUidCpuFreqTime();
-    bool ReadFreqTimeIncrement(std::map<uint32_t, std::vector<int64_t>>& speedTime,
-        std::map<uint32_t, std::vector<int64_t>>& increments, int32_t uid, std::vector<std::string>& splitedTime);
-    bool ProcessFreqTime(std::map<uint32_t, std::vector<int64_t>>& map, std::map<uint32_t,
-        std::vector<int64_t>>& increments, std::map<uint32_t, std::vector<int64_t>>& speedTime, int32_t index,
-        int32_t uid);
-    void DistributeFreqTime(std::map<uint32_t, std::vector<int64_t>>& uidIncrements,
-        std::map<uint32_t, std::vector<int64_t>>& increments);
-    void AddFreqTimeToUid(std::map<uint32_t, std::vector<int64_t>>& uidIncrements, int32_t uid);
+    bool ReadFreqTimeIncrement(uint32_t index);
+    void DistributeFreqTime();
+    void AddFreqTimeToUid(uint32_t index);
     bool ReadUidCpuTime();
-    void UpdateUidTimeMap(int32_t uid, const std::vector<int64_t>& uidIncrements);
-    bool ReadUidTimeIncrement(std::vector<int64_t>& clusterTime, std::vector<int64_t>& uidIncrements, int32_t uid,
-        std::string& timeLine);
-    void Split(std::string &origin, char delimiter, std::vector<std::string> &splited);
+    bool ReadPidCpuTime();
+    void UpdateUidTime(uint32_t index, const UidTime& uidIncrements);
+    bool ReadUidTimeIncrement(const UidTime& cpuTime, UidTime& uidIncrements, uint32_t index);
 };
 } // namespace PowerMgr
 } // namespace OHOS
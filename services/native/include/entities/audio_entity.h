@@ -16,8 +16,6 @@
 #ifndef AUDIO_ENTITY_H
 #define AUDIO_ENTITY_H
 
-#include <map>
-
 #include "entities/battery_stats_entity.h"
 #include "stats_helper.h"
 
@@ -35,9 +33,6 @@ public:
     std::shared_ptr<StatsHelper::ActiveTimer> GetOrCreateTimer(int32_t uid, StatsUtils::StatsType statsType,
         int16_t level = StatsUtils::INVALID_VALUE) override;
     void Reset() override;
-private:
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> audioTimerMap_;
-    std::map<int32_t, double> audioPowerMap_;
 };
 } // namespace PowerMgr
 } // namespace OHOS
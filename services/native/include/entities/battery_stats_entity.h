@@ -21,11 +21,24 @@
 #include <memory>
 #include <vector>
 #include "stats_utils.h"
+#include "stats_arena.h"
 #include "stats_helper.h"
+#include "stats_timer_store.h"
 #include "battery_stats_info.h"
 
 namespace OHOS {
 namespace PowerMgr {
+/**
+ * One computed consumption entry, the Parcelable BatteryStatsInfo is only built from it at the IPC boundary.
+ */
+struct StatsResultRecord {
+    BatteryStatsInfo::ConsumptionType type = BatteryStatsInfo::CONSUMPTION_TYPE_INVALID;
+    int32_t uid = StatsUtils::INVALID_VALUE;
+    int32_t userId = StatsUtils::INVALID_VALUE;
+    double powerMah = StatsUtils::DEFAULT_VALUE;
+};
+using StatsResultTable = std::vector<StatsResultRecord>;
+
 class BatteryStatsEntity {
 public:
     BatteryStatsEntity() = default;
@@ -51,16 +64,25 @@ public:
     virtual void UpdateUidMap(int32_t uid);
     virtual int64_t GetCpuTimeMs(int32_t uid);
     virtual void UpdateCpuTime();
+    virtual void SetParallelRead(bool parallelRead);
     virtual std::vector<int32_t> GetUids();
     virtual void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE);
     BatteryStatsInfo::ConsumptionType GetConsumptionType();
     static double GetTotalPowerMah();
     static void ResetStatsEntity();
     static BatteryStatsInfoList GetStatsInfoList();
-    static void UpdateStatsInfoList(std::shared_ptr<BatteryStatsInfo> info);
+    static const StatsResultTable& GetStatsResults();
+    static void AddStatsResult(BatteryStatsInfo::ConsumptionType type, double powerMah,
+        int32_t uid = StatsUtils::INVALID_VALUE, int32_t userId = StatsUtils::INVALID_VALUE);
+    static StatsTimerStore& GetTimerStore();
+    static void SetStatsArena(const std::shared_ptr<StatsArena>& arena);
 protected:
+    static std::shared_ptr<StatsHelper::ActiveTimer> AllocateTimer();
+    static std::shared_ptr<StatsHelper::Counter> AllocateCounter();
     static double totalPowerMah_;
-    static BatteryStatsInfoList statsInfoList_;
+    static StatsResultTable statsResults_;
+    static StatsTimerStore timerStore_;
+    static std::shared_ptr<StatsArena> statsArena_;
     BatteryStatsInfo::ConsumptionType consumptionType_ = BatteryStatsInfo::CONSUMPTION_TYPE_INVALID;
 };
 } // namespace PowerMgr
@@ -16,19 +16,12 @@
 #ifndef BLUETOOTH_ENTITY_H
 #define BLUETOOTH_ENTITY_H
 
-#include <map>
-
 #include "entities/battery_stats_entity.h"
 
 namespace OHOS {
 namespace PowerMgr {
 class BluetoothEntity : public BatteryStatsEntity {
 public:
-    enum PowerType {
-        POWER_TYPE_BR = 0,
-        POWER_TYPE_BLE,
-        POWER_TYPE_ALL,
-    };
     BluetoothEntity();
     ~BluetoothEntity() = default;
     void Calculate(int32_t uid = StatsUtils::INVALID_VALUE) override;
@@ -48,17 +41,11 @@ private:
     double GetBluetoothUidPower();
     void CalculateBtPower();
     void CalculateBtPowerForApp(int32_t uid);
-    void UpdateAppBluetoothBlePower(PowerType type, int32_t uid, double powerMah);
     double bluetoothBrPowerMah_ = StatsUtils::DEFAULT_VALUE;
     double bluetoothBlePowerMah_ = StatsUtils::DEFAULT_VALUE;
     double bluetoothPowerMah_ = StatsUtils::DEFAULT_VALUE;
-    std::map<int32_t, double> appBluetoothBrPowerMap_;
-    std::map<int32_t, double> appBluetoothBlePowerMap_;
-    std::map<int32_t, double> appBluetoothPowerMap_;
     std::shared_ptr<StatsHelper::ActiveTimer> bluetoothBrOnTimer_;
     std::shared_ptr<StatsHelper::ActiveTimer> bluetoothBleOnTimer_;
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> appBluetoothBrScanTimerMap_;
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> appBluetoothBleScanTimerMap_;
 };
 } // namespace PowerMgr
 } // namespace OHOS
@@ -16,8 +16,6 @@
 #ifndef CAMERA_ENTITY_H
 #define CAMERA_ENTITY_H
 
-#include <map>
-
 #include "entities/battery_stats_entity.h"
 #include "stats_helper.h"
 
@@ -35,9 +33,6 @@ public:
     std::shared_ptr<StatsHelper::ActiveTimer> GetOrCreateTimer(const std::string& deviceId, int32_t uid,
         StatsUtils::StatsType statsType, int16_t level = StatsUtils::INVALID_VALUE) override;
     void Reset() override;
-private:
-    std::map<std::string, std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>> cameraTimerMap_;
-    std::map<int32_t, double> cameraPowerMap_;
 };
 } // namespace PowerMgr
 } // namespace OHOS
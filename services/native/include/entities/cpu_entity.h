@@ -16,7 +16,8 @@
 #ifndef CPU_ENTITY_H
 #define CPU_ENTITY_H
 
-#include <map>
+#include <mutex>
+#include <vector>
 
 #include "cpu_time_reader.h"
 #include "entities/battery_stats_entity.h"
@@ -35,15 +36,30 @@ public:
     void Reset() override;
     void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE) override;
     void UpdateCpuTime() override;
+    void SetParallelRead(bool parallelRead) override;
+    void SetProcRoot(const std::string& procRoot);
 private:
+    struct UidCpuStats {
+        int64_t cpuTimeMs = StatsUtils::DEFAULT_VALUE;
+        double totalPowerMah = StatsUtils::DEFAULT_VALUE;
+        double activePowerMah = StatsUtils::DEFAULT_VALUE;
+        double clusterPowerMah = StatsUtils::DEFAULT_VALUE;
+        double speedPowerMah = StatsUtils::DEFAULT_VALUE;
+    };
+    UidCpuStats* GetOrCreateUidStats(int32_t uid);
+    static bool IsWeightedCpuTime();
+    void CalculateAll();
+    void CalculateUid(UidCpuStats& stats, int32_t uid, double cpuSpeedPower, bool isWeighted);
+    const UidCpuStats* FindUidStats(int32_t uid) const;
+    // The sampler thread updates the reader while binder threads calculate, dump and query the stats
+    std::mutex cpuEntityMutex_;
     std::shared_ptr<CpuTimeReader> cpuReader_;
-    std::map<int32_t, int64_t> cpuTimeMap_;
-    std::map<int32_t, double> cpuTotalPowerMap_;
-    std::map<int32_t, double> cpuActivePowerMap_;
-    std::map<int32_t, double> cpuClusterPowerMap_;
-    std::map<int32_t, double> cpuSpeedPowerMap_;
-    double CalculateCpuActivePower(int32_t uid);
-    double CalculateCpuClusterPower(int32_t uid);
+    // Indexed by the dense uid index of StatsUidInterner
+    std::vector<UidCpuStats> uidCpuStats_;
+    // Speed power of every uid index from the last batched calculation
+    std::vector<double> speedPowers_;
+    double CalculateCpuActivePower(int32_t uid, bool isWeighted);
+    double CalculateCpuClusterPower(int32_t uid, bool isWeighted);
     double CalculateCpuSpeedPower(int32_t uid);
 };
 } // namespace PowerMgr
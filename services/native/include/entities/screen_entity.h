@@ -16,7 +16,7 @@
 #ifndef SCREEN_ENTITY_H
 #define SCREEN_ENTITY_H
 
-#include <map>
+#include <cstdint>
 
 #include "entities/battery_stats_entity.h"
 
@@ -24,6 +24,7 @@ namespace OHOS {
 namespace PowerMgr {
 class ScreenEntity : public BatteryStatsEntity {
 public:
+    static constexpr int32_t BRIGHTNESS_LEVEL_COUNT = StatsUtils::SCREEN_BRIGHTNESS_BIN + 1;
     ScreenEntity();
     ~ScreenEntity() = default;
     void Calculate(int32_t uid = StatsUtils::INVALID_VALUE) override;
@@ -34,11 +35,28 @@ public:
     void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE) override;
     std::shared_ptr<StatsHelper::ActiveTimer> GetOrCreateTimer(StatsUtils::StatsType statsType,
         int16_t level = StatsUtils::INVALID_VALUE) override;
+    bool StartBrightnessTimer(int16_t level);
+    bool StopBrightnessTimer(int16_t level = StatsUtils::INVALID_VALUE);
+    void GetBrightnessTimesMs(int64_t (&timesMs)[BRIGHTNESS_LEVEL_COUNT]);
 private:
+    class BrightnessTimerView;
+    int64_t GetBrightnessTimeMs(int16_t level);
     int64_t GetBrightnessTotalTimeMs();
+    void AddBrightnessTimeMs(int16_t level, int64_t activeTimeMs);
+    void ResetBrightnessTimer(int16_t level);
+    void FoldRunningBrightnessTime();
+    void UpdateBrightnessLevelMa(double brightnessAverageMa);
     double screenPowerMah_ = StatsUtils::DEFAULT_VALUE;
     std::shared_ptr<StatsHelper::ActiveTimer> screenOnTimer_;
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> screenBrightnessTimerMap_;
+    // Brightness time of every level, only one level can be running at a time
+    int64_t brightnessTimeMs_[BRIGHTNESS_LEVEL_COUNT] = {};
+    int16_t runningBrightnessLevel_ = StatsUtils::INVALID_VALUE;
+    int64_t runningBrightnessStartMs_ = StatsUtils::DEFAULT_VALUE;
+    // Views handed out by GetOrCreateTimer, one per level
+    std::shared_ptr<StatsHelper::ActiveTimer> brightnessTimers_[BRIGHTNESS_LEVEL_COUNT];
+    // Average current of every level, rebuilt when the configured brightness current changes
+    double brightnessLevelMa_[BRIGHTNESS_LEVEL_COUNT] = {};
+    double brightnessAverageMa_ = StatsUtils::DEFAULT_VALUE;
 };
 } // namespace PowerMgr
 } // namespace OHOS
@@ -16,8 +16,8 @@
 #ifndef UID_ENTITY_H
 #define UID_ENTITY_H
 
-#include <map>
 #include <mutex>
+#include <vector>
 
 #include "entities/battery_stats_entity.h"
 #include "stats_helper.h"
@@ -38,7 +38,13 @@ public:
     void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE) override;
 private:
     std::mutex uidEntityMutex_;
-    std::map<int32_t, double> uidPowerMap_;
+    // App power consumption indexed by the dense uid index of StatsUidInterner
+    std::vector<double> uidPowerMah_;
+    // User that the power in uidPowerMah_ was last added to, same index
+    std::vector<int32_t> uidUserIds_;
+    void SyncUidIndexes();
+    void UpdateUserPowerMah(const std::shared_ptr<BatteryStatsEntity>& userEntity, uint32_t index,
+        int32_t userId, double power);
     void AddtoStatsList(int32_t uid, double power);
     double GetPowerForCommon(StatsUtils::StatsType statsType, int32_t uid);
     double GetPowerForConnectivity(StatsUtils::StatsType statsType, int32_t uid);
@@ -32,6 +32,7 @@ public:
     void Calculate(int32_t uid = StatsUtils::INVALID_VALUE) override;
     void Reset() override;
 private:
+    // Running totals per user id, UidEntity hands over the change of every app power on each calculation
     std::map<int32_t, double> userPowerMap_;
 };
 } // namespace PowerMgr
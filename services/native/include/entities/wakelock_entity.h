@@ -16,13 +16,22 @@
 #ifndef WAKELOCK_ENTITY_H
 #define WAKELOCK_ENTITY_H
 
-#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "entities/battery_stats_entity.h"
 #include "stats_helper.h"
 
 namespace OHOS {
 namespace PowerMgr {
+struct WakelockHoldTime {
+    int32_t uid;
+    std::string name;
+    int64_t holdTimeMs;
+};
+
 class WakelockEntity : public BatteryStatsEntity {
 public:
     WakelockEntity();
@@ -35,9 +44,19 @@ public:
     std::shared_ptr<StatsHelper::ActiveTimer> GetOrCreateTimer(int32_t uid, StatsUtils::StatsType statsType,
         int16_t level = StatsUtils::INVALID_VALUE) override;
     void Reset() override;
+    void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE) override;
+    void UpdateLockName(StatsUtils::StatsState state, int32_t uid, const std::string& name,
+        bool isAllHolders = false);
+    std::vector<WakelockHoldTime> GetTopWakelocks(size_t count);
+    void GetHoldTimesMs(std::vector<int64_t>& holdTimesMs);
 private:
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> wakelockTimerMap_;
-    std::map<int32_t, double> wakelockPowerMap_;
+    static constexpr size_t MAX_LOCK_NAMES = 1024;
+    uint32_t InternLockName(const std::string& name);
+    std::string GetLockName(uint32_t nameId);
+    std::mutex lockNameMutex_;
+    // Compact table of all lock names, id 0 is the overflow name "other"
+    std::unordered_map<std::string, uint32_t> lockNameIds_;
+    std::vector<std::string> lockNames_ { "other" };
 };
 } // namespace PowerMgr
 } // namespace OHOS
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PID_CPU_TIME_READER_H
+#define PID_CPU_TIME_READER_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Fallback for kernels without the uid cpu accounting files: scans /proc/[pid]/stat and /proc/[pid]/status and
+ * sums utime and stime by uid. Every pid keeps a baseline of its times and start time, so a scan only charges the
+ * time a process used since the previous scan, a reused pid starts over, and exited pids are dropped.
+ * The time an exited process used after the last scan is not seen.
+ */
+class PidCpuTimeReader {
+public:
+    struct UidCpuTime {
+        int64_t userTimeMs = 0;
+        int64_t systemTimeMs = 0;
+    };
+
+    PidCpuTimeReader();
+    ~PidCpuTimeReader() = default;
+    void SetProcRoot(const std::string& procRoot);
+    bool Scan();
+    const std::unordered_map<int32_t, UidCpuTime>& GetUidIncrements() const;
+    size_t GetPidCount() const;
+    void DumpInfo(std::string& result) const;
+
+private:
+    struct PidBaseline {
+        int64_t startTime = 0;
+        int64_t userTicks = 0;
+        int64_t systemTicks = 0;
+        uint32_t generation = 0;
+    };
+    bool ReadPid(int32_t dirFd, const char* name, int32_t pid);
+    bool ReadPidFile(int32_t dirFd, const char* name, const char* file, size_t& size);
+    bool ParseStat(size_t size, int64_t& userTicks, int64_t& systemTicks, int64_t& startTime) const;
+    bool ParseStatusUid(size_t size, int32_t& uid) const;
+    void RemoveExitedPids();
+    void ConvertIncrements();
+    std::string procRoot_ = "/proc";
+    int64_t ticksPerSecond_ = 0;
+    uint32_t generation_ = 0;
+    std::unordered_map<int32_t, PidBaseline> baselines_;
+    // Clock ticks while a scan runs, ms once it has finished
+    std::unordered_map<int32_t, UidCpuTime> uidIncrements_;
+    // Scratch buffers reused by every scan
+    std::vector<char> direntBuffer_;
+    std::vector<char> fileBuffer_;
+    std::string path_;
+    uint32_t exitedCount_ = 0;
+    int64_t scanTimeUs_ = 0;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // PID_CPU_TIME_READER_H
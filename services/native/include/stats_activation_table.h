@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATS_ACTIVATION_TABLE_H
+#define STATS_ACTIVATION_TABLE_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Live holders of the per-uid timers, keyed by (uid, pid, resource) with the nesting depth of every holder, plus
+ * one aggregate entry per (uid, resource) counting its live holders. The uid timer runs while the aggregate is
+ * non-zero, so the stop of one process no longer ends the interval of another process of the same uid.
+ * All entries share one open-addressing table with linear probing and backward-shift deletion, so there are no
+ * tombstones and the table stays as small as the number of live holders.
+ */
+class StatsActivationTable {
+public:
+    StatsActivationTable();
+    ~StatsActivationTable() = default;
+    // True if this made the first holder of the uid active and the uid timer has to start
+    bool Activate(int32_t uid, int32_t pid, uint32_t resource);
+    // True if this made the last holder of the uid inactive and the uid timer has to stop
+    bool Deactivate(int32_t uid, int32_t pid, uint32_t resource);
+    uint32_t GetHolderCount(int32_t uid, uint32_t resource);
+    uint32_t GetDepth(int32_t uid, int32_t pid, uint32_t resource);
+    size_t GetEntryCount();
+    size_t GetCapacity();
+    void Clear();
+
+private:
+    static constexpr size_t INITIAL_CAPACITY = 64;
+    struct Entry {
+        int32_t uid;
+        int32_t pid;
+        uint32_t resource;
+        // Zero marks a free entry
+        uint32_t count;
+    };
+    static size_t Hash(int32_t uid, int32_t pid, uint32_t resource);
+    bool Find(int32_t uid, int32_t pid, uint32_t resource, size_t& pos) const;
+    size_t Insert(int32_t uid, int32_t pid, uint32_t resource);
+    void Erase(size_t pos);
+    bool DeactivateUid(int32_t uid, uint32_t resource);
+    void Grow();
+    std::mutex mutex_;
+    std::vector<Entry> entries_;
+    size_t entryCount_ = 0;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // STATS_ACTIVATION_TABLE_H
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATS_ARENA_H
+#define STATS_ARENA_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "stats_helper.h"
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Slab allocator for the timers and counters of the entities.
+ * Objects are carved out of fixed-size slabs and handed out as aliasing shared_ptr, which share the control
+ * block of their slab instead of allocating one each. Every entity resets its own objects, and a slab is freed
+ * once the arena and all handles into it are gone.
+ */
+class StatsArena {
+public:
+    StatsArena() = default;
+    ~StatsArena() = default;
+    std::shared_ptr<StatsHelper::ActiveTimer> AllocateTimer();
+    std::shared_ptr<StatsHelper::Counter> AllocateCounter();
+    size_t GetTimerCount();
+    size_t GetCounterCount();
+    size_t GetArenaBytes();
+
+private:
+    static constexpr size_t SLAB_SIZE = 64;
+    template<typename T>
+    class SlabPool {
+    public:
+        std::shared_ptr<T> Allocate()
+        {
+            if (slabs_.empty() || used_ == SLAB_SIZE) {
+                slabs_.push_back(std::make_shared<std::array<T, SLAB_SIZE>>());
+                used_ = 0;
+            }
+            auto& slab = slabs_.back();
+            return std::shared_ptr<T>(slab, &(*slab)[used_++]);
+        }
+
+        size_t GetCount() const
+        {
+            return slabs_.empty() ? 0 : (slabs_.size() - 1) * SLAB_SIZE + used_;
+        }
+
+        size_t GetBytes() const
+        {
+            return slabs_.size() * sizeof(std::array<T, SLAB_SIZE>);
+        }
+    private:
+        std::vector<std::shared_ptr<std::array<T, SLAB_SIZE>>> slabs_;
+        size_t used_ = 0;
+    };
+    std::mutex mutex_;
+    SlabPool<StatsHelper::ActiveTimer> timerPool_;
+    SlabPool<StatsHelper::Counter> counterPool_;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // STATS_ARENA_H
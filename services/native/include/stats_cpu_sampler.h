@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATS_CPU_SAMPLER_H
+#define STATS_CPU_SAMPLER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "stats_utils.h"
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Schedules the per-uid cpu time samples on a worker thread of its own, so the proc files are never read on an
+ * IPC thread. A sample is taken on battery and screen transitions, before power is computed unless the last
+ * sample is recent enough or another one is in flight, and periodically otherwise. The period is short on
+ * battery with the screen on and long otherwise, and is measured on the monotonic clock, which stops in suspend,
+ * so sampling never wakes the device by itself.
+ */
+class StatsCpuSampler {
+public:
+    enum Trigger : uint32_t {
+        TRIGGER_PERIODIC = 0,
+        TRIGGER_BATTERY,
+        TRIGGER_SCREEN,
+        TRIGGER_COMPUTE,
+        TRIGGER_COUNT,
+    };
+    static constexpr int64_t ACTIVE_INTERVAL_MS = 60 * 1000;
+    static constexpr int64_t IDLE_INTERVAL_MS = 10 * 60 * 1000;
+    static constexpr int64_t COMPUTE_MIN_AGE_MS = 5 * 1000;
+    static constexpr int64_t SAMPLE_WAIT_MS = 200;
+    using SampleCallback = std::function<void()>;
+
+    explicit StatsCpuSampler(SampleCallback callback) : callback_(std::move(callback)) {}
+    ~StatsCpuSampler();
+    void Start();
+    void Stop();
+    void SetOnBattery(bool isOnBattery);
+    void SetScreenOn(bool isScreenOn);
+    void RequestSample(Trigger trigger);
+    // With minAgeMs set, a sample younger than that or one already running or queued is used instead of a new one
+    bool SampleNow(Trigger trigger, int64_t minAgeMs = StatsUtils::DEFAULT_VALUE);
+    int64_t GetIntervalMs();
+    uint64_t GetSampleCount(Trigger trigger);
+    void DumpInfo(std::string& result);
+
+private:
+    void Run();
+    void Sample(std::unique_lock<std::mutex>& lock, Trigger trigger);
+    int64_t GetIntervalMsLocked() const;
+    SampleCallback callback_;
+    std::mutex mutex_;
+    std::condition_variable requestCond_;
+    std::condition_variable doneCond_;
+    std::thread worker_;
+    bool isRunning_ = false;
+    bool isSampling_ = false;
+    bool isOnBattery_ = false;
+    bool isScreenOn_ = false;
+    bool isIntervalChanged_ = false;
+    // Requests are numbered, a waiter is done once the sample that started after its request has completed
+    uint64_t requestedSeq_ = 0;
+    uint64_t completedSeq_ = 0;
+    Trigger pendingTrigger_ = TRIGGER_PERIODIC;
+    uint64_t sampleCounts_[TRIGGER_COUNT] {};
+    uint64_t rateLimitedCount_ = 0;
+    uint64_t inFlightSkippedCount_ = 0;
+    int64_t lastSampleTimeMs_ = StatsUtils::INVALID_VALUE;
+    int64_t lastIntervalMs_ = StatsUtils::DEFAULT_VALUE;
+    int64_t lastCostUs_ = StatsUtils::DEFAULT_VALUE;
+    int64_t maxCostUs_ = StatsUtils::DEFAULT_VALUE;
+    int64_t totalCostUs_ = StatsUtils::DEFAULT_VALUE;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // STATS_CPU_SAMPLER_H
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATS_HISTORY_H
+#define STATS_HISTORY_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "battery_stats_info.h"
+#include "entities/battery_stats_entity.h"
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Rolling energy history of the last 24 hours in 5-minute buckets, one row per consumption type and one per
+ * app uid. Every compute hands over the cumulative result table, and only the increase since the previous
+ * compute is added to the current bucket, as int32 in uAh. App rows are indexed by the StatsUidInterner index
+ * and only allocated once the uid consumed power, so memory stays bounded by the number of draining apps.
+ */
+class StatsHistory {
+public:
+    static constexpr int64_t BUCKET_DURATION_MS = 5 * 60 * 1000;
+    static constexpr int32_t BUCKET_COUNT = 24 * 60 * 60 * 1000 / BUCKET_DURATION_MS;
+
+    StatsHistory() = default;
+    ~StatsHistory() = default;
+    void Record(int64_t timeMs, const StatsResultTable& results);
+    bool IsBucketDue(int64_t timeMs);
+    double GetPartPowerMah(BatteryStatsInfo::ConsumptionType type, int64_t beginTimeMs, int64_t endTimeMs);
+    double GetAppPowerMah(int32_t uid, int64_t beginTimeMs, int64_t endTimeMs);
+    void ResetBaseline();
+    size_t GetAppRowCount();
+    size_t GetHistoryBytes();
+    void DumpInfo(std::string& result, int64_t timeMs);
+
+private:
+    static constexpr int32_t PART_COUNT = BatteryStatsInfo::CONSUMPTION_TYPE_ALARM -
+        BatteryStatsInfo::CONSUMPTION_TYPE_INVALID;
+    using BucketRow = std::array<int32_t, BUCKET_COUNT>;
+    static bool GetPartIndex(BatteryStatsInfo::ConsumptionType type, int32_t& index);
+    static int64_t TakeDeltaUah(int64_t& lastUah, double cumulativeMah);
+    void AdvanceTo(int64_t epoch);
+    void AddToBucket(BucketRow& row, int64_t deltaUah);
+    double SumRow(const BucketRow& row, int64_t beginTimeMs, int64_t endTimeMs) const;
+    std::mutex mutex_;
+    int64_t currentEpoch_ = StatsUtils::INVALID_VALUE;
+    BucketRow partRows_[PART_COUNT] {};
+    int64_t lastPartUah_[PART_COUNT] {};
+    std::vector<std::unique_ptr<BucketRow>> appRows_;
+    std::vector<int64_t> lastAppUah_;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // STATS_HISTORY_H
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATS_LEDGER_H
+#define STATS_LEDGER_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "battery_stats_info.h"
+#include "entities/battery_stats_entity.h"
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Accounting windows over the power totals. The totals since boot are the totals since the last reset plus
+ * everything folded in at earlier resets. A window only stores the totals since boot captured at its marker,
+ * one value per consumption type followed by one per StatsUidInterner index, and is read as the current
+ * totals minus that baseline, so the events themselves never touch a ledger.
+ */
+class StatsLedger {
+public:
+    static constexpr const char* LEDGER_BOOT = "boot";
+    static constexpr const char* LEDGER_RESET = "reset";
+    static constexpr const char* LEDGER_UNPLUG = "unplug";
+    static constexpr size_t MAX_CUSTOM_LEDGERS = 8;
+
+    StatsLedger() = default;
+    ~StatsLedger() = default;
+    void Record(const StatsResultTable& results);
+    void FoldOnReset();
+    bool Mark(const std::string& name);
+    bool GetPowerMah(const std::string& name, BatteryStatsInfo::ConsumptionType type, int32_t uid,
+        double& powerMah);
+    void DumpInfo(std::string& result);
+
+private:
+    static bool GetPartIndex(BatteryStatsInfo::ConsumptionType type, int32_t& index);
+    static bool IsBuiltinLedger(const std::string& name);
+    bool GetKey(BatteryStatsInfo::ConsumptionType type, int32_t uid, size_t& key);
+    void CaptureBaseline(const std::string& name);
+    double GetSinceBootMah(size_t key) const;
+    std::mutex mutex_;
+    // Totals of the last compute and the totals folded in at every reset before, same layout as a baseline
+    std::vector<double> currentMah_;
+    std::vector<double> foldedMah_;
+    std::map<std::string, std::vector<double>> baselines_;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // STATS_LEDGER_H
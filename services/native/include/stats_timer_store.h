@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATS_TIMER_STORE_H
+#define STATS_TIMER_STORE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "stats_helper.h"
+#include "stats_utils.h"
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Per-uid timers of all app entities, kept as one column per timer kind and indexed by the dense uid index
+ * from StatsUidInterner, so every column shares the same index and a per-uid query reads adjacent memory
+ * instead of walking one map per entity.
+ * Named timers split one uid further by an interned name id, at most MAX_NAMED_TIMERS_PER_UID per uid, and
+ * names beyond that share the NAME_ID_OTHER timer of the uid.
+ * Kinds backed by one shared piece of hardware also keep a share clock, advancing by elapsed / number of running
+ * holders. A holder's shared time is the clock advance while it runs, so every time slice is split evenly among
+ * the holders active in it at O(1) per transition. No source tells how much of the hardware one holder drives,
+ * so the split carries no per-holder weight. ACCOUNTING_SHARED reports the shared time,
+ * ACCOUNTING_EXCLUSIVE the full wall time of every holder. CpuEntity follows the same mode for the cpu time.
+ */
+class StatsTimerStore {
+public:
+    enum TimerKind : uint32_t {
+        TIMER_KIND_BLUETOOTH_BR_SCAN = 0,
+        TIMER_KIND_BLUETOOTH_BLE_SCAN,
+        TIMER_KIND_CAMERA_ON,
+        TIMER_KIND_FLASHLIGHT_ON,
+        TIMER_KIND_GNSS_ON,
+        TIMER_KIND_SENSOR_GRAVITY_ON,
+        TIMER_KIND_SENSOR_PROXIMITY_ON,
+        TIMER_KIND_AUDIO_ON,
+        TIMER_KIND_WAKELOCK_HOLD,
+        TIMER_KIND_COUNT,
+    };
+
+    enum AccountingMode : uint32_t {
+        ACCOUNTING_EXCLUSIVE = 0,
+        ACCOUNTING_SHARED,
+    };
+
+    static constexpr uint32_t NAME_ID_OTHER = 0;
+    static constexpr size_t MAX_NAMED_TIMERS_PER_UID = 16;
+    struct NamedTime {
+        int32_t uid;
+        uint32_t nameId;
+        int64_t totalTimeMs;
+    };
+
+    StatsTimerStore() = default;
+    ~StatsTimerStore() = default;
+    static bool GetTimerKind(StatsUtils::StatsType statsType, TimerKind& kind);
+    static bool IsSharedKind(TimerKind kind);
+    void SetAccountingMode(AccountingMode mode);
+    AccountingMode GetAccountingMode();
+    int64_t GetSharedTimeMs(TimerKind kind, int32_t uid);
+    bool StartRunning(TimerKind kind, int32_t uid);
+    bool StopRunning(TimerKind kind, int32_t uid);
+    int64_t GetRunningTimeMs(TimerKind kind, int32_t uid);
+    void AddRunningTimeMs(TimerKind kind, int32_t uid, int64_t activeTimeMs);
+    void SetPowerMah(TimerKind kind, int32_t uid, double powerMah);
+    double GetPowerMah(TimerKind kind, int32_t uid);
+    void GetTotalTimesMs(TimerKind kind, std::vector<int64_t>& totalTimesMs);
+    // Both resets zero the times and power and stop the running timers, of one kind or of one uid of it
+    void Reset(TimerKind kind);
+    void Reset(TimerKind kind, int32_t uid);
+    std::shared_ptr<StatsHelper::ActiveTimer> GetTimer(TimerKind kind, int32_t uid);
+    size_t GetSlotCount();
+    bool StartNamedRunning(int32_t uid, uint32_t nameId);
+    bool StopNamedRunning(int32_t uid, uint32_t nameId, bool isAllHolders = false);
+    std::vector<NamedTime> GetNamedTimes();
+    // Running named timers are kept and count on from the reset, their holders still stop them later
+    void ResetNamed();
+
+private:
+    class TimerView;
+    struct TimerColumn {
+        std::vector<int64_t> startTimeMs;
+        std::vector<int64_t> totalTimeMs;
+        std::vector<uint8_t> isRunning;
+        std::vector<double> powerMah;
+        std::vector<double> shareStart;
+        std::vector<double> sharedTimeMs;
+        // Views handed out by GetTimer, created on first use and shared by every later caller
+        std::vector<std::shared_ptr<StatsHelper::ActiveTimer>> views;
+        double shareClock = 0.0;
+        uint32_t runningCount = 0;
+        int64_t shareClockTimeMs = StatsUtils::DEFAULT_VALUE;
+    };
+    struct NamedTimer {
+        uint32_t nameId;
+        // Holders of the same name overlap, the timer runs until the last one stops
+        uint32_t runningCount;
+        int64_t startTimeMs;
+        int64_t totalTimeMs;
+    };
+    static void AdvanceShareClock(TimerColumn& column, int64_t nowMs);
+    static void FoldSharedTime(TimerColumn& column, uint32_t slot);
+    NamedTimer* FindNamedTimer(uint32_t slot, uint32_t nameId, bool create);
+    uint32_t GetOrCreateSlot(int32_t uid);
+    bool FindSlot(int32_t uid, uint32_t& slot) const;
+    std::mutex mutex_;
+    AccountingMode accountingMode_ = ACCOUNTING_EXCLUSIVE;
+    uint32_t slotCount_ = 0;
+    TimerColumn columns_[TIMER_KIND_COUNT];
+    // Named timers of every uid, indexed by slot like the columns
+    std::vector<std::vector<NamedTimer>> namedTimers_;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // STATS_TIMER_STORE_H
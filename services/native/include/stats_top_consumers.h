@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATS_TOP_CONSUMERS_H
+#define STATS_TOP_CONSUMERS_H
+
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * The apps with the highest power consumption, kept in a min-heap of at most MAX_TOP_CONSUMERS entries with a
+ * position index per StatsUidInterner index. UidEntity updates it for every uid whose power changed, a query
+ * only copies the heap as of the last calculation. An app pushed out of the heap is only brought back by its own
+ * update, so anything that lowers app power, like switching the accounting mode, has to invalidate the heap. The
+ * next calculation then updates every uid again.
+ */
+class StatsTopConsumers {
+public:
+    static constexpr int32_t MAX_TOP_CONSUMERS = 32;
+
+    StatsTopConsumers() = default;
+    ~StatsTopConsumers() = default;
+    void Update(uint32_t index, double powerMah);
+    std::vector<std::pair<int32_t, double>> GetTopConsumers(int32_t count);
+    void Reset();
+    void Invalidate();
+    bool TakeInvalidated();
+
+private:
+    struct HeapEntry {
+        uint32_t index;
+        double powerMah;
+    };
+    void Swap(size_t first, size_t second);
+    void SiftUp(size_t pos);
+    void SiftDown(size_t pos);
+    std::mutex mutex_;
+    std::vector<HeapEntry> heap_;
+    // Heap position per uid index, -1 if the uid is not among the top consumers
+    std::vector<int32_t> heapPos_;
+    bool isInvalidated_ = false;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // STATS_TOP_CONSUMERS_H
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATS_UID_INTERNER_H
+#define STATS_UID_INTERNER_H
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Process-wide mapping from sparse app uids to dense indices.
+ * A uid gets the next free index on first sight and keeps it for the lifetime of the process, so per-uid
+ * storage can be a plain vector indexed the same way in the CPU reader and in every entity.
+ * The owning user of a uid is asked from the account service on first use, cached next to it and dropped when
+ * users are added or removed.
+ */
+class StatsUidInterner {
+public:
+    static StatsUidInterner& GetInstance();
+    uint32_t Intern(int32_t uid);
+    void InternBatch(const int32_t* uids, size_t count, uint32_t* indexes);
+    bool Find(int32_t uid, uint32_t& index);
+    int32_t GetUid(uint32_t index);
+    uint32_t GetCount();
+    std::vector<int32_t> GetUids();
+    int32_t GetUserId(int32_t uid);
+    void InvalidateUserIds();
+
+private:
+    StatsUidInterner() = default;
+    ~StatsUidInterner() = default;
+    uint32_t InternLocked(int32_t uid);
+    std::mutex mutex_;
+    std::unordered_map<int32_t, uint32_t> uidIndexMap_;
+    std::vector<int32_t> indexUids_;
+    std::vector<int32_t> indexUserIds_;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // STATS_UID_INTERNER_H
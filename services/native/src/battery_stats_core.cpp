@@ -26,7 +26,6 @@
 #include <cJSON.h>
 
 #include "ios"
-#include "ohos_account_kits.h"
 
 #include "battery_info.h"
 #include "battery_srv_client.h"
@@ -47,6 +46,8 @@
 #include "entities/alarm_entity.h"
 #include "stats_cjson_utils.h"
 #include "stats_helper.h"
+#include "stats_timer_store.h"
+#include "stats_uid_interner.h"
 
 #include "xcollie/xcollie.h"
 #include "xcollie/xcollie_define.h"
@@ -55,6 +56,8 @@ namespace OHOS {
 namespace PowerMgr {
 namespace {
 static const std::string BATTERY_STATS_JSON = "/data/service/el0/stats/battery_stats.json";
+// Camera sessions hold their activations under pids below StatsUtils::INVALID_VALUE, which no process uses
+constexpr int32_t CAMERA_SESSION_PID_BASE = -2;
 } // namespace
 void BatteryStatsCore::CreatePartEntity()
 {
@@ -127,6 +130,7 @@ void BatteryStatsCore::CreateAppEntity()
 bool BatteryStatsCore::Init()
 {
     STATS_HILOGI(COMP_SVC, "Battery stats core init");
+    BatteryStatsEntity::SetStatsArena(statsArena_);
     CreateAppEntity();
     CreatePartEntity();
     auto& batterySrvClient = BatterySrvClient::GetInstance();
@@ -140,10 +144,20 @@ bool BatteryStatsCore::Init()
     if (!LoadBatteryStatsData()) {
         STATS_HILOGW(COMP_SVC, "Load battery stats data failed");
     }
+    cpuSampler_->SetOnBattery(StatsHelper::IsOnBattery());
+    cpuSampler_->Start();
     return true;
 }
 
 void BatteryStatsCore::ComputePower()
+{
+    // Sampled on the sampler thread, without the lock held since the sample takes it. A sample in flight is not
+    // waited for, the power is computed from the last one
+    cpuSampler_->SampleNow(StatsCpuSampler::TRIGGER_COMPUTE, StatsCpuSampler::COMPUTE_MIN_AGE_MS);
+    CalculatePower();
+}
+
+void BatteryStatsCore::CalculatePower()
 {
     std::lock_guard lock(mutex_);
     STATS_HILOGD(COMP_SVC, "Calculate battery stats");
@@ -159,6 +173,8 @@ void BatteryStatsCore::ComputePower()
     screenEntity_->Calculate();
     wifiEntity_->Calculate();
     userEntity_->Calculate();
+    statsHistory_->Record(StatsHelper::GetBootTimeMs(), BatteryStatsEntity::GetStatsResults());
+    statsLedger_->Record(BatteryStatsEntity::GetStatsResults());
 
     HiviewDFX::XCollie::GetInstance().CancelTimer(id);
 }
@@ -232,7 +248,7 @@ void BatteryStatsCore::UpdateStats(StatsUtils::StatsType statsType, int64_t time
 }
 
 void BatteryStatsCore::UpdateConnectivityStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state,
-    int32_t uid)
+    int32_t uid, int32_t pid)
 {
     switch (statsType) {
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_ON:
@@ -244,33 +260,34 @@ void BatteryStatsCore::UpdateConnectivityStats(StatsUtils::StatsType statsType,
             break;
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN:
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN:
-            UpdateTimer(bluetoothEntity_, statsType, state, uid);
+            UpdateTimer(bluetoothEntity_, statsType, state, uid, pid);
             break;
         default:
             break;
     }
 }
 
-void BatteryStatsCore::UpdateCommonStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid)
+void BatteryStatsCore::UpdateCommonStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid,
+    int32_t pid)
 {
     switch (statsType) {
         case StatsUtils::STATS_TYPE_FLASHLIGHT_ON:
-            UpdateTimer(flashlightEntity_, statsType, state, uid);
+            UpdateTimer(flashlightEntity_, statsType, state, uid, pid);
             break;
         case StatsUtils::STATS_TYPE_GNSS_ON:
-            UpdateTimer(gnssEntity_, statsType, state, uid);
+            UpdateTimer(gnssEntity_, statsType, state, uid, pid);
             break;
         case StatsUtils::STATS_TYPE_SENSOR_GRAVITY_ON:
-            UpdateTimer(sensorEntity_, statsType, state, uid);
+            UpdateTimer(sensorEntity_, statsType, state, uid, pid);
             break;
         case StatsUtils::STATS_TYPE_SENSOR_PROXIMITY_ON:
-            UpdateTimer(sensorEntity_, statsType, state, uid);
+            UpdateTimer(sensorEntity_, statsType, state, uid, pid);
             break;
         case StatsUtils::STATS_TYPE_AUDIO_ON:
-            UpdateTimer(audioEntity_, statsType, state, uid);
+            UpdateTimer(audioEntity_, statsType, state, uid, pid);
             break;
         case StatsUtils::STATS_TYPE_WAKELOCK_HOLD:
-            UpdateTimer(wakelockEntity_, statsType, state, uid);
+            UpdateTimer(wakelockEntity_, statsType, state, uid, pid);
             break;
         default:
             break;
@@ -278,7 +295,7 @@ void BatteryStatsCore::UpdateCommonStats(StatsUtils::StatsType statsType, StatsU
 }
 
 void BatteryStatsCore::UpdateStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level,
-    int32_t uid, const std::string& deviceId)
+    int32_t uid, const std::string& deviceId, int32_t pid)
 {
     STATS_HILOGD(COMP_SVC,
         "Update for state, statsType: %{public}s, uid: %{public}d, state: %{public}d, level: %{public}d,"   \
@@ -306,7 +323,7 @@ void BatteryStatsCore::UpdateStats(StatsUtils::StatsType statsType, StatsUtils::
         case StatsUtils::STATS_TYPE_WIFI_ON:
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN:
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN:
-            UpdateConnectivityStats(statsType, state, uid);
+            UpdateConnectivityStats(statsType, state, uid, pid);
             break;
         case StatsUtils::STATS_TYPE_FLASHLIGHT_ON:
         case StatsUtils::STATS_TYPE_GNSS_ON:
@@ -314,11 +331,89 @@ void BatteryStatsCore::UpdateStats(StatsUtils::StatsType statsType, StatsUtils::
         case StatsUtils::STATS_TYPE_SENSOR_PROXIMITY_ON:
         case StatsUtils::STATS_TYPE_AUDIO_ON:
         case StatsUtils::STATS_TYPE_WAKELOCK_HOLD:
-            UpdateCommonStats(statsType, state, uid);
+            UpdateCommonStats(statsType, state, uid, pid);
             break;
         default:
             break;
     }
+    // A stopped activity closes the history bucket it ran in, so its power is not smeared into a later bucket.
+    // The compute runs on the sampler thread, the thread reporting the event does not wait for it
+    if (state == StatsUtils::STATS_STATE_DEACTIVATED && statsHistory_->IsBucketDue(StatsHelper::GetBootTimeMs()) &&
+        !isBucketCloseDue_.exchange(true)) {
+        cpuSampler_->RequestSample(StatsCpuSampler::TRIGGER_COMPUTE);
+    }
+}
+
+void BatteryStatsCore::UpdateWakelockStats(StatsUtils::StatsState state, int32_t uid, const std::string& name,
+    int32_t pid)
+{
+    // A stop without a process that has no holder of its own ends every holder of the uid, the named timer too
+    bool isAllHolders = state == StatsUtils::STATS_STATE_DEACTIVATED && pid == StatsUtils::INVALID_VALUE &&
+        activations_->GetDepth(uid, pid, StatsTimerStore::TIMER_KIND_WAKELOCK_HOLD) == 0;
+    UpdateStats(StatsUtils::STATS_TYPE_WAKELOCK_HOLD, state, StatsUtils::INVALID_VALUE, uid, "", pid);
+    wakelockEntity_->UpdateLockName(state, uid, name, isAllHolders);
+}
+
+std::vector<WakelockHoldTime> BatteryStatsCore::GetTopWakelocks(size_t count)
+{
+    return wakelockEntity_->GetTopWakelocks(count);
+}
+
+void BatteryStatsCore::GetWakelockHoldTimesMs(std::vector<int64_t>& holdTimesMs)
+{
+    wakelockEntity_->GetHoldTimesMs(holdTimesMs);
+}
+
+void BatteryStatsCore::SetAccountingMode(StatsTimerStore::AccountingMode mode)
+{
+    if (BatteryStatsEntity::GetTimerStore().GetAccountingMode() == mode) {
+        return;
+    }
+    BatteryStatsEntity::GetTimerStore().SetAccountingMode(mode);
+    // The shared times are lower than the exclusive ones, the heap is rebuilt from the last sample right away
+    topConsumers_->Invalidate();
+    CalculatePower();
+}
+
+void BatteryStatsCore::SetCpuParallelRead(bool parallelRead)
+{
+    if (cpuEntity_) {
+        cpuEntity_->SetParallelRead(parallelRead);
+    }
+}
+
+void BatteryStatsCore::SetOnBattery(bool isOnBattery)
+{
+    if (isOnBattery != StatsHelper::IsOnBattery()) {
+        // The cpu time up to the transition still belongs to the previous state
+        cpuSampler_->SampleNow(StatsCpuSampler::TRIGGER_BATTERY);
+    }
+    StatsHelper::SetOnBattery(isOnBattery);
+    cpuSampler_->SetOnBattery(isOnBattery);
+}
+
+std::shared_ptr<StatsCpuSampler> BatteryStatsCore::GetCpuSampler()
+{
+    return cpuSampler_;
+}
+
+void BatteryStatsCore::UpdateCpuTime()
+{
+    std::lock_guard lock(mutex_);
+    if (cpuEntity_) {
+        cpuEntity_->UpdateCpuTime();
+    }
+}
+
+void BatteryStatsCore::OnCpuSample()
+{
+    UpdateCpuTime();
+    // The periodic samples close the buckets of long stretches without stop events or computes
+    bool isBucketDue = statsHistory_->IsBucketDue(StatsHelper::GetBootTimeMs());
+    if (isBucketCloseDue_.exchange(false) || isBucketDue) {
+        // The cpu time was just sampled, the due bucket only needs the calculation
+        CalculatePower();
+    }
 }
 
 void BatteryStatsCore::UpdateScreenStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level)
@@ -340,27 +435,15 @@ void BatteryStatsCore::UpdateScreenStats(StatsUtils::StatsType statsType, StatsU
 void BatteryStatsCore::UpdateCameraStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state,
     int32_t uid, const std::string& deviceId)
 {
-    STATS_HILOGD(COMP_SVC, "Camera status: %{public}d, Last camera uid: %{public}d", isCameraOn_, lastCameraUid_);
+    STATS_HILOGD(COMP_SVC, "Camera status: %{public}d, Last camera slot: %{public}d", state, lastCameraSlot_);
     if (statsType == StatsUtils::STATS_TYPE_CAMERA_ON) {
         if (state == StatsUtils::STATS_STATE_ACTIVATED) {
-            if (isCameraOn_) {
-                STATS_HILOGW(COMP_SVC, "Camera is already opened, return");
-                return;
-            }
-            UpdateCameraTimer(state, uid, deviceId);
+            OpenCameraSession(uid, deviceId);
         } else if (state == StatsUtils::STATS_STATE_DEACTIVATED) {
-            if (!isCameraOn_) {
-                STATS_HILOGW(COMP_SVC, "Camera is off, return");
-                return;
-            }
-            UpdateCameraTimer(state, lastCameraUid_, deviceId);
+            CloseCameraSession(deviceId);
         }
     } else if (statsType == StatsUtils::STATS_TYPE_CAMERA_FLASHLIGHT_ON) {
-        if (!isCameraOn_) {
-            STATS_HILOGW(COMP_SVC, "Camera is off, return");
-            return;
-        }
-        UpdateTimer(flashlightEntity_, StatsUtils::STATS_TYPE_FLASHLIGHT_ON, state, lastCameraUid_);
+        UpdateCameraFlashlight(state, deviceId);
     }
 }
 
@@ -388,7 +471,7 @@ void BatteryStatsCore::UpdatePhoneStats(StatsUtils::StatsType statsType, StatsUt
 }
 
 void BatteryStatsCore::UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, StatsUtils::StatsType statsType,
-    StatsUtils::StatsState state, int32_t uid)
+    StatsUtils::StatsState state, int32_t uid, int32_t pid)
 {
     STATS_HILOGD(COMP_SVC,
         "entity: %{public}s, statsType: %{public}s, state: %{public}d, uid: %{public}d",
@@ -396,6 +479,17 @@ void BatteryStatsCore::UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, S
         StatsUtils::ConvertStatsType(statsType).c_str(),
         state,
         uid);
+    StatsTimerStore::TimerKind kind;
+    if (uid > StatsUtils::INVALID_VALUE && StatsTimerStore::GetTimerKind(statsType, kind)) {
+        // Per-uid timers live in the shared timer store and run while any process of the uid holds the resource
+        if (state == StatsUtils::STATS_STATE_ACTIVATED && activations_->Activate(uid, pid, kind)) {
+            BatteryStatsEntity::GetTimerStore().StartRunning(kind, uid);
+        } else if (state == StatsUtils::STATS_STATE_DEACTIVATED && activations_->Deactivate(uid, pid, kind)) {
+            BatteryStatsEntity::GetTimerStore().StopRunning(kind, uid);
+        }
+        return;
+    }
+
     std::shared_ptr<StatsHelper::ActiveTimer> timer;
     if (uid > StatsUtils::INVALID_VALUE) {
         timer = entity->GetOrCreateTimer(uid, statsType);
@@ -429,6 +523,12 @@ void BatteryStatsCore::UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, S
         StatsUtils::ConvertStatsType(statsType).c_str(),
         time,
         uid);
+    StatsTimerStore::TimerKind kind;
+    if (uid > StatsUtils::INVALID_VALUE && StatsTimerStore::GetTimerKind(statsType, kind)) {
+        BatteryStatsEntity::GetTimerStore().AddRunningTimeMs(kind, uid, time);
+        return;
+    }
+
     std::shared_ptr<StatsHelper::ActiveTimer> timer;
     if (uid > StatsUtils::INVALID_VALUE) {
         timer = entity->GetOrCreateTimer(uid, statsType);
@@ -443,71 +543,126 @@ void BatteryStatsCore::UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, S
     timer->AddRunningTimeMs(time);
 }
 
-void BatteryStatsCore::UpdateCameraTimer(StatsUtils::StatsState state, int32_t uid, const std::string& deviceId)
+int32_t BatteryStatsCore::FindCameraSession(const std::string& deviceId) const
 {
-    STATS_HILOGD(COMP_SVC, "Camera status: %{public}d, uid: %{public}d, deviceId: %{private}s",
-        state, uid, deviceId.c_str());
-    std::shared_ptr<StatsHelper::ActiveTimer> timer;
-    if (uid > StatsUtils::INVALID_VALUE && deviceId != "") {
-        timer = cameraEntity_->GetOrCreateTimer(deviceId, uid, StatsUtils::STATS_TYPE_CAMERA_ON);
-    } else {
-        timer = cameraEntity_->GetOrCreateTimer(StatsUtils::STATS_TYPE_CAMERA_ON);
+    for (int32_t slot = 0; slot < MAX_CAMERA_SESSIONS; slot++) {
+        if (cameraSessions_[slot].uid > StatsUtils::INVALID_VALUE && cameraSessions_[slot].deviceId == deviceId) {
+            return slot;
+        }
     }
+    return StatsUtils::INVALID_VALUE;
+}
 
-    if (timer == nullptr) {
-        STATS_HILOGW(COMP_SVC, "Timer is null, return");
+void BatteryStatsCore::OpenCameraSession(int32_t uid, const std::string& deviceId)
+{
+    if (uid <= StatsUtils::INVALID_VALUE) {
+        STATS_HILOGW(COMP_SVC, "Invalid camera uid, return");
         return;
     }
+    if (FindCameraSession(deviceId) > StatsUtils::INVALID_VALUE) {
+        STATS_HILOGW(COMP_SVC, "Camera: %{private}s is already opened, return", deviceId.c_str());
+        return;
+    }
+    int32_t slot = 0;
+    while (slot < MAX_CAMERA_SESSIONS && cameraSessions_[slot].uid > StatsUtils::INVALID_VALUE) {
+        slot++;
+    }
+    if (slot == MAX_CAMERA_SESSIONS) {
+        STATS_HILOGW(COMP_SVC, "Too many opened cameras, ignore: %{private}s", deviceId.c_str());
+        return;
+    }
+    FoldCameraOverlap(uid);
+    cameraSessions_[slot] = {deviceId, uid, false, StatsHelper::GetOnBatteryBootTimeMs()};
+    lastCameraSlot_ = slot;
+    // Sessions of one uid share its camera timer, the slot tells the sessions apart in the activation table
+    UpdateTimer(cameraEntity_, StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_ACTIVATED, uid,
+        CAMERA_SESSION_PID_BASE - slot);
+}
 
-    switch (state) {
-        case StatsUtils::STATS_STATE_ACTIVATED: {
-            if (timer->StartRunning()) {
-                isCameraOn_ = true;
-                lastCameraUid_ = uid;
+void BatteryStatsCore::CloseCameraSession(const std::string& deviceId)
+{
+    int32_t slot = deviceId.empty() ? lastCameraSlot_ : FindCameraSession(deviceId);
+    if (slot <= StatsUtils::INVALID_VALUE) {
+        STATS_HILOGW(COMP_SVC, "Camera: %{private}s is off, return", deviceId.c_str());
+        return;
+    }
+    auto& session = cameraSessions_[slot];
+    if (session.isFlashlightOn) {
+        UpdateTimer(flashlightEntity_, StatsUtils::STATS_TYPE_FLASHLIGHT_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+            session.uid, CAMERA_SESSION_PID_BASE - slot);
+    }
+    FoldCameraOverlap(session.uid);
+    UpdateTimer(cameraEntity_, StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_DEACTIVATED, session.uid,
+        CAMERA_SESSION_PID_BASE - slot);
+    session = CameraSession();
+    if (lastCameraSlot_ == slot) {
+        lastCameraSlot_ = StatsUtils::INVALID_VALUE;
+        for (int32_t i = 0; i < MAX_CAMERA_SESSIONS; i++) {
+            if (cameraSessions_[i].uid > StatsUtils::INVALID_VALUE) {
+                lastCameraSlot_ = i;
             }
-            break;
         }
-        case StatsUtils::STATS_STATE_DEACTIVATED: {
-            if (timer->StopRunning()) {
-                UpdateTimer(flashlightEntity_,
-                            StatsUtils::STATS_TYPE_FLASHLIGHT_ON,
-                            StatsUtils::STATS_STATE_DEACTIVATED,
-                            lastCameraUid_);
-                isCameraOn_ = false;
-                lastCameraUid_ = StatsUtils::INVALID_VALUE;
-            }
-            break;
+    }
+}
+
+void BatteryStatsCore::FoldCameraOverlap(int32_t uid)
+{
+    // The camera timer of a uid runs once for all its sessions, every further open session adds its time here
+    int64_t nowMs = StatsHelper::GetOnBatteryBootTimeMs();
+    int64_t overlapSinceMs = nowMs;
+    int64_t sessionCount = 0;
+    for (auto& session : cameraSessions_) {
+        if (session.uid == uid) {
+            sessionCount++;
+            overlapSinceMs = session.overlapSinceMs;
+            session.overlapSinceMs = nowMs;
         }
-        default:
-            break;
     }
+    if (sessionCount > 1 && nowMs > overlapSinceMs) {
+        UpdateTimer(cameraEntity_, StatsUtils::STATS_TYPE_CAMERA_ON, (sessionCount - 1) * (nowMs - overlapSinceMs),
+            uid);
+    }
+}
+
+void BatteryStatsCore::UpdateCameraFlashlight(StatsUtils::StatsState state, const std::string& deviceId)
+{
+    // The flashlight event names its camera when it can, otherwise it belongs to the latest opened one
+    int32_t slot = deviceId.empty() ? lastCameraSlot_ : FindCameraSession(deviceId);
+    if (slot <= StatsUtils::INVALID_VALUE) {
+        STATS_HILOGW(COMP_SVC, "Camera is off, return");
+        return;
+    }
+    auto& session = cameraSessions_[slot];
+    bool isFlashlightOn = state == StatsUtils::STATS_STATE_ACTIVATED;
+    if ((state != StatsUtils::STATS_STATE_ACTIVATED && state != StatsUtils::STATS_STATE_DEACTIVATED) ||
+        session.isFlashlightOn == isFlashlightOn) {
+        return;
+    }
+    session.isFlashlightOn = isFlashlightOn;
+    UpdateTimer(flashlightEntity_, StatsUtils::STATS_TYPE_FLASHLIGHT_ON, state, session.uid,
+        CAMERA_SESSION_PID_BASE - slot);
 }
 
 void BatteryStatsCore::UpdateScreenTimer(StatsUtils::StatsState state)
 {
     std::shared_ptr<StatsHelper::ActiveTimer> screenOnTimer = nullptr;
-    std::shared_ptr<StatsHelper::ActiveTimer> brightnessTimer = nullptr;
     screenOnTimer = screenEntity_->GetOrCreateTimer(StatsUtils::STATS_TYPE_SCREEN_ON);
-    if (lastBrightnessLevel_ > StatsUtils::INVALID_VALUE) {
-        brightnessTimer = screenEntity_->GetOrCreateTimer(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS,
-            lastBrightnessLevel_);
-    }
     if (state == StatsUtils::STATS_STATE_ACTIVATED) {
         if (screenOnTimer != nullptr) {
             screenOnTimer->StartRunning();
         }
-        if (brightnessTimer != nullptr) {
-            brightnessTimer->StartRunning();
+        if (lastBrightnessLevel_ > StatsUtils::INVALID_VALUE) {
+            screenEntity_->StartBrightnessTimer(lastBrightnessLevel_);
         }
         isScreenOn_ = true;
+        cpuSampler_->SetScreenOn(true);
     } else if (state == StatsUtils::STATS_STATE_DEACTIVATED) {
         if (screenOnTimer != nullptr) {
             screenOnTimer->StopRunning();
         }
-        if (brightnessTimer != nullptr) {
-            brightnessTimer->StopRunning();
-        }
+        screenEntity_->StopBrightnessTimer();
         isScreenOn_ = false;
+        cpuSampler_->SetScreenOn(false);
     }
 }
 
@@ -518,27 +673,12 @@ void BatteryStatsCore::UpdateBrightnessTimer(StatsUtils::StatsState state, int16
         return;
     }
 
-    if (lastBrightnessLevel_ <= StatsUtils::INVALID_VALUE ||
-        (level > StatsUtils::INVALID_VALUE && level == lastBrightnessLevel_)) {
-        auto brightnessTimer = screenEntity_->GetOrCreateTimer(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS,
-            level);
-        if (brightnessTimer != nullptr) {
-            brightnessTimer->StartRunning();
-        }
-    } else if (level != lastBrightnessLevel_) {
-        auto oldBrightnessTimer = screenEntity_->GetOrCreateTimer(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS,
-            lastBrightnessLevel_);
-        auto newBrightnessTimer = screenEntity_->GetOrCreateTimer(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, level);
-        if (oldBrightnessTimer != nullptr) {
-            STATS_HILOGI(COMP_SVC, "Stop screen brightness timer for last level: %{public}d",
-                lastBrightnessLevel_);
-            oldBrightnessTimer->StopRunning();
-        }
-        if (newBrightnessTimer != nullptr) {
-            STATS_HILOGI(COMP_SVC, "Start screen brightness timer for latest level: %{public}d", level);
-            newBrightnessTimer->StartRunning();
-        }
+    if (lastBrightnessLevel_ > StatsUtils::INVALID_VALUE && level != lastBrightnessLevel_) {
+        STATS_HILOGI(COMP_SVC, "Switch screen brightness timer from level: %{public}d to level: %{public}d",
+            lastBrightnessLevel_, level);
     }
+    // Starting a new level closes the interval of the last one
+    screenEntity_->StartBrightnessTimer(level);
     lastBrightnessLevel_ = level;
 }
 
@@ -628,6 +768,28 @@ void BatteryStatsCore::DumpInfo(std::string& result)
         uidEntity_->DumpInfo(result);
         result.append("\n");
     }
+    if (wakelockEntity_) {
+        wakelockEntity_->DumpInfo(result);
+        result.append("\n");
+    }
+    if (cpuEntity_) {
+        cpuEntity_->DumpInfo(result);
+        result.append("\n");
+    }
+    cpuSampler_->DumpInfo(result);
+    result.append("\n");
+    result.append("Stats arena dump:\n")
+        .append("Timer count: ")
+        .append(ToString(statsArena_->GetTimerCount()))
+        .append(", counter count: ")
+        .append(ToString(statsArena_->GetCounterCount()))
+        .append(", arena bytes: ")
+        .append(ToString(statsArena_->GetArenaBytes()))
+        .append("\n\n");
+    statsHistory_->DumpInfo(result, StatsHelper::GetBootTimeMs());
+    result.append("\n");
+    statsLedger_->DumpInfo(result);
+    result.append("\n");
     GetDebugInfo(result);
 }
 
@@ -718,13 +880,11 @@ int64_t BatteryStatsCore::GetTotalConsumptionCount(StatsUtils::StatsType statsTy
 double BatteryStatsCore::GetAppStatsMah(const int32_t& uid)
 {
     double appStatsMah = StatsUtils::DEFAULT_VALUE;
-    auto statsInfoList = GetBatteryStats();
-    for (auto iter = statsInfoList.begin(); iter != statsInfoList.end(); iter++) {
-        if ((*iter)->GetConsumptionType() == BatteryStatsInfo::CONSUMPTION_TYPE_APP) {
-            if ((*iter)->GetUid() == uid) {
-                appStatsMah = (*iter)->GetPower();
-                break;
-            }
+    std::lock_guard lock(mutex_);
+    for (const auto& record : BatteryStatsEntity::GetStatsResults()) {
+        if (record.type == BatteryStatsInfo::CONSUMPTION_TYPE_APP && record.uid == uid) {
+            appStatsMah = record.powerMah;
+            break;
         }
     }
     STATS_HILOGD(COMP_SVC, "Get stats mah: %{public}lf for uid: %{public}d", appStatsMah, uid);
@@ -734,18 +894,16 @@ double BatteryStatsCore::GetAppStatsMah(const int32_t& uid)
 double BatteryStatsCore::GetAppStatsPercent(const int32_t& uid)
 {
     double appStatsPercent = StatsUtils::DEFAULT_VALUE;
-    auto statsInfoList = GetBatteryStats();
+    std::lock_guard lock(mutex_);
     auto totalConsumption = BatteryStatsEntity::GetTotalPowerMah();
     if (totalConsumption <= StatsUtils::DEFAULT_VALUE) {
         STATS_HILOGW(COMP_SVC, "No consumption got, return 0");
         return appStatsPercent;
     }
-    for (auto iter = statsInfoList.begin(); iter != statsInfoList.end(); iter++) {
-        if ((*iter)->GetConsumptionType() == BatteryStatsInfo::CONSUMPTION_TYPE_APP) {
-            if ((*iter)->GetUid() == uid && totalConsumption != StatsUtils::DEFAULT_VALUE) {
-                appStatsPercent = (*iter)->GetPower() / totalConsumption;
-                break;
-            }
+    for (const auto& record : BatteryStatsEntity::GetStatsResults()) {
+        if (record.type == BatteryStatsInfo::CONSUMPTION_TYPE_APP && record.uid == uid) {
+            appStatsPercent = record.powerMah / totalConsumption;
+            break;
         }
     }
     STATS_HILOGD(COMP_SVC, "Get stats percent: %{public}lf for uid: %{public}d", appStatsPercent, uid);
@@ -755,10 +913,10 @@ double BatteryStatsCore::GetAppStatsPercent(const int32_t& uid)
 double BatteryStatsCore::GetPartStatsMah(const BatteryStatsInfo::ConsumptionType& type)
 {
     double partStatsMah = StatsUtils::DEFAULT_VALUE;
-    auto statsInfoList = GetBatteryStats();
-    for (auto iter = statsInfoList.begin(); iter != statsInfoList.end(); iter++) {
-        if ((*iter)->GetConsumptionType() == type) {
-            partStatsMah = (*iter)->GetPower();
+    std::lock_guard lock(mutex_);
+    for (const auto& record : BatteryStatsEntity::GetStatsResults()) {
+        if (record.type == type) {
+            partStatsMah = record.powerMah;
             break;
         }
     }
@@ -769,11 +927,11 @@ double BatteryStatsCore::GetPartStatsMah(const BatteryStatsInfo::ConsumptionType
 double BatteryStatsCore::GetPartStatsPercent(const BatteryStatsInfo::ConsumptionType& type)
 {
     double partStatsPercent = StatsUtils::DEFAULT_VALUE;
-    auto statsInfoList = GetBatteryStats();
+    std::lock_guard lock(mutex_);
     auto totalConsumption = BatteryStatsEntity::GetTotalPowerMah();
-    for (auto iter = statsInfoList.begin(); iter != statsInfoList.end(); iter++) {
-        if ((*iter)->GetConsumptionType() == type && totalConsumption != StatsUtils::DEFAULT_VALUE) {
-            partStatsPercent = (*iter)->GetPower() / totalConsumption;
+    for (const auto& record : BatteryStatsEntity::GetStatsResults()) {
+        if (record.type == type && totalConsumption != StatsUtils::DEFAULT_VALUE) {
+            partStatsPercent = record.powerMah / totalConsumption;
             break;
         }
     }
@@ -810,9 +968,10 @@ void BatteryStatsCore::SaveForHardware(cJSON* root)
     }
     cJSON* screenBrightnessArray = cJSON_CreateArray();
     if (screenBrightnessArray) {
-        for (uint16_t brightness = 0; brightness <= StatsUtils::SCREEN_BRIGHTNESS_BIN; brightness++) {
-            if (!cJSON_AddItemToArray(screenBrightnessArray,
-                cJSON_CreateNumber(GetTotalTimeMs(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, brightness)))) {
+        int64_t brightnessTimesMs[ScreenEntity::BRIGHTNESS_LEVEL_COUNT] = {};
+        screenEntity_->GetBrightnessTimesMs(brightnessTimesMs);
+        for (int64_t timeMs : brightnessTimesMs) {
+            if (!cJSON_AddItemToArray(screenBrightnessArray, cJSON_CreateNumber(timeMs))) {
                 STATS_HILOGW(COMP_SVC, "Add screen_brightness array failed.");
             }
         }
@@ -1025,22 +1184,19 @@ void BatteryStatsCore::SaveForPower(cJSON* root)
         }
     }
 
-    auto statsInfoList = BatteryStatsEntity::GetStatsInfoList();
-    for (auto iter = statsInfoList.begin(); iter != statsInfoList.end(); iter++) {
-        if ((*iter)->GetConsumptionType() == BatteryStatsInfo::CONSUMPTION_TYPE_APP) {
-            std::string name = std::to_string((*iter)->GetUid());
-            if (cJSON_AddNumberToObject(powerObj, name.c_str(), (*iter)->GetPower()) == nullptr) {
+    for (const auto& record : BatteryStatsEntity::GetStatsResults()) {
+        if (record.type == BatteryStatsInfo::CONSUMPTION_TYPE_APP) {
+            std::string name = std::to_string(record.uid);
+            if (cJSON_AddNumberToObject(powerObj, name.c_str(), record.powerMah) == nullptr) {
                 STATS_HILOGW(COMP_SVC, "Add %{public}s to powerObj failed.", name.c_str());
             }
-            STATS_HILOGD(COMP_SVC, "Saved power: %{public}lf for uid: %{public}s", (*iter)->GetPower(),
-                name.c_str());
-        } else if ((*iter)->GetConsumptionType() != BatteryStatsInfo::CONSUMPTION_TYPE_USER) {
-            std::string name = std::to_string((*iter)->GetConsumptionType());
-            if (cJSON_AddNumberToObject(powerObj, name.c_str(), (*iter)->GetPower()) == nullptr) {
+            STATS_HILOGD(COMP_SVC, "Saved power: %{public}lf for uid: %{public}s", record.powerMah, name.c_str());
+        } else if (record.type != BatteryStatsInfo::CONSUMPTION_TYPE_USER) {
+            std::string name = std::to_string(record.type);
+            if (cJSON_AddNumberToObject(powerObj, name.c_str(), record.powerMah) == nullptr) {
                 STATS_HILOGW(COMP_SVC, "Add %{public}s to powerObj failed.", name.c_str());
             }
-            STATS_HILOGD(COMP_SVC, "Saved power: %{public}lf for type: %{public}s", (*iter)->GetPower(),
-                name.c_str());
+            STATS_HILOGD(COMP_SVC, "Saved power: %{public}lf for type: %{public}s", record.powerMah, name.c_str());
         }
     }
 }
@@ -1111,32 +1267,24 @@ void BatteryStatsCore::UpdateStatsEntity(cJSON* root)
         }
         auto id = static_cast<int32_t>(result);
         int32_t usr = StatsUtils::INVALID_VALUE;
-        std::shared_ptr<BatteryStatsInfo> info = std::make_shared<BatteryStatsInfo>();
+        double power = currentElement->valuedouble;
         if (id > StatsUtils::INVALID_VALUE) {
-            info->SetUid(id);
-            info->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
-            info->SetPower(currentElement->valuedouble);
-            usr = AccountSA::OhosAccountKits::GetInstance().GetDeviceAccountIdByUID(id);
+            usr = StatsUidInterner::GetInstance().GetUserId(id);
             const auto& userPower = tmpUserPowerMap.find(usr);
             if (userPower != tmpUserPowerMap.end()) {
-                userPower->second += info->GetPower();
+                userPower->second += power;
             } else {
-                tmpUserPowerMap.insert(std::pair<int32_t, double>(usr, info->GetPower()));
+                tmpUserPowerMap.insert(std::pair<int32_t, double>(usr, power));
             }
+            BatteryStatsEntity::AddStatsResult(BatteryStatsInfo::CONSUMPTION_TYPE_APP, power, id);
         } else if (id < StatsUtils::INVALID_VALUE && id > BatteryStatsInfo::CONSUMPTION_TYPE_INVALID) {
-            info->SetUid(StatsUtils::INVALID_VALUE);
-            info->SetConsumptioType(static_cast<BatteryStatsInfo::ConsumptionType>(id));
-            info->SetPower(currentElement->valuedouble);
+            BatteryStatsEntity::AddStatsResult(static_cast<BatteryStatsInfo::ConsumptionType>(id), power);
         }
-        STATS_HILOGD(COMP_SVC, "Load power:%{public}lfmAh,id:%{public}d,user:%{public}d", info->GetPower(), id, usr);
-        BatteryStatsEntity::UpdateStatsInfoList(info);
+        STATS_HILOGD(COMP_SVC, "Load power:%{public}lfmAh,id:%{public}d,user:%{public}d", power, id, usr);
     }
     for (auto& iter : tmpUserPowerMap) {
-        std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-        statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_USER);
-        statsInfo->SetUserId(iter.first);
-        statsInfo->SetPower(iter.second);
-        BatteryStatsEntity::UpdateStatsInfoList(statsInfo);
+        BatteryStatsEntity::AddStatsResult(BatteryStatsInfo::CONSUMPTION_TYPE_USER, iter.second,
+            StatsUtils::INVALID_VALUE, iter.first);
     }
 }
 
@@ -1182,8 +1330,54 @@ bool BatteryStatsCore::LoadBatteryStatsData()
     return true;
 }
 
+std::shared_ptr<StatsArena> BatteryStatsCore::GetStatsArena()
+{
+    return statsArena_;
+}
+
+double BatteryStatsCore::GetHistoryMah(const BatteryStatsInfo::ConsumptionType& type, int32_t uid,
+    int64_t beginTimeMs, int64_t endTimeMs)
+{
+    if (type == BatteryStatsInfo::CONSUMPTION_TYPE_APP && uid > StatsUtils::INVALID_VALUE) {
+        return statsHistory_->GetAppPowerMah(uid, beginTimeMs, endTimeMs);
+    }
+    return statsHistory_->GetPartPowerMah(type, beginTimeMs, endTimeMs);
+}
+
+std::shared_ptr<StatsTopConsumers> BatteryStatsCore::GetStatsTopConsumers()
+{
+    return topConsumers_;
+}
+
+BatteryStatsInfoList BatteryStatsCore::GetTopConsumers(int32_t count)
+{
+    BatteryStatsInfoList statsInfoList;
+    for (const auto& consumer : topConsumers_->GetTopConsumers(count)) {
+        std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
+        statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
+        statsInfo->SetUid(consumer.first);
+        statsInfo->SetPower(consumer.second);
+        statsInfoList.push_back(statsInfo);
+    }
+    return statsInfoList;
+}
+
+bool BatteryStatsCore::MarkLedger(const std::string& name)
+{
+    ComputePower();
+    return statsLedger_->Mark(name);
+}
+
+bool BatteryStatsCore::GetLedgerMah(const std::string& name, const BatteryStatsInfo::ConsumptionType& type,
+    int32_t uid, double& powerMah)
+{
+    return statsLedger_->GetPowerMah(name, type, uid, powerMah);
+}
+
 void BatteryStatsCore::Reset()
 {
+    // The totals are brought up to date first, so the ledgers keep everything consumed before the reset
+    ComputePower();
     std::lock_guard lock(mutex_);
     audioEntity_->Reset();
     bluetoothEntity_->Reset();
@@ -1200,6 +1394,14 @@ void BatteryStatsCore::Reset()
     wifiEntity_->Reset();
     wakelockEntity_->Reset();
     alarmEntity_->Reset();
+    statsHistory_->ResetBaseline();
+    topConsumers_->Reset();
+    statsLedger_->FoldOnReset();
+    // The reset stopped every timer, holders that are still active start them again with their next activation
+    activations_->Clear();
+    for (auto& session : cameraSessions_) {
+        session.overlapSinceMs = StatsHelper::GetOnBatteryBootTimeMs();
+    }
     BatteryStatsEntity::ResetStatsEntity();
     debugInfo_.clear();
 }
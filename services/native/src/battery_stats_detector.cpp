@@ -49,9 +49,12 @@ void BatteryStatsDetector::HandleStatsChangedEvent(StatsUtils::StatsData data)
         // Update related timer with reported time
         // The traffic won't participate the power consumption calculation, just for dump info
         core->UpdateStats(data.type, data.time, data.traffic, data.uid);
+    } else if (data.type == StatsUtils::STATS_TYPE_WAKELOCK_HOLD) {
+        // Update the uid timer and the timer of the lock name
+        core->UpdateWakelockStats(data.state, data.uid, data.eventDataName, data.pid);
     } else if (IsStateRelated(data.type)) {
         // Update related timer based on state or level
-        core->UpdateStats(data.type, data.state, data.level, data.uid, data.deviceId);
+        core->UpdateStats(data.type, data.state, data.level, data.uid, data.deviceId, data.pid);
     }
     HandleDebugInfo(data);
 }
@@ -24,6 +24,12 @@ namespace {
 constexpr const char* ARGS_HELP = "-h";
 constexpr const char* ARGS_STATS = "-batterystats";
 constexpr const char* ARGS_POWER_AVERAGE = "-poweraverage";
+constexpr const char* ARGS_ACCOUNTING = "-accounting";
+constexpr const char* ACCOUNTING_SHARED = "shared";
+constexpr const char* ACCOUNTING_EXCLUSIVE = "exclusive";
+constexpr const char* ARGS_CPU_PARALLEL = "-cpuparallel";
+constexpr const char* SWITCH_ON = "on";
+constexpr const char* SWITCH_OFF = "off";
 }
 
 bool BatteryStatsDumper::Dump(const std::vector<std::string>& args, std::string& result)
@@ -51,6 +57,33 @@ bool BatteryStatsDumper::Dump(const std::vector<std::string>& args, std::string&
                 continue;
             }
             parser->DumpInfo(result);
+        } else if (*it == ARGS_ACCOUNTING && (it + 1) != args.end()) {
+            auto core = bss->GetBatteryStatsCore();
+            if (core == nullptr) {
+                continue;
+            }
+            ++it;
+            if (*it == ACCOUNTING_SHARED) {
+                core->SetAccountingMode(StatsTimerStore::ACCOUNTING_SHARED);
+            } else if (*it == ACCOUNTING_EXCLUSIVE) {
+                core->SetAccountingMode(StatsTimerStore::ACCOUNTING_EXCLUSIVE);
+            } else {
+                result.append("Unknown accounting mode: ").append(*it).append("\n");
+                continue;
+            }
+            result.append("Accounting mode: ").append(*it).append("\n");
+        } else if (*it == ARGS_CPU_PARALLEL && (it + 1) != args.end()) {
+            auto core = bss->GetBatteryStatsCore();
+            if (core == nullptr) {
+                continue;
+            }
+            ++it;
+            if (*it != SWITCH_ON && *it != SWITCH_OFF) {
+                result.append("Unknown cpu parallel read switch: ").append(*it).append("\n");
+                continue;
+            }
+            core->SetCpuParallelRead(*it == SWITCH_ON);
+            result.append("Cpu parallel read: ").append(*it).append("\n");
         }
     }
     return true;
@@ -63,7 +96,12 @@ void BatteryStatsDumper::ShowUsage(std::string& result)
         "command list:\n"
         "  -h              :    Show this help menu. \n"
         "  -batterystats   :    Show all the information of battery stats.\n"
-        "  -poweraverage   :    Show all the information of power average configuration.\n";
+        "  -poweraverage   :    Show all the information of power average configuration.\n"
+        "  -accounting <exclusive|shared> :    Count shared hardware time in full for every holder, or split it\n"
+        "                                      among the concurrent holders. Shared also weights the cpu time of\n"
+        "                                      an app by the number of cpus active at the same time.\n"
+        "  -cpuparallel <on|off>          :    Read the cpu time proc files on worker threads, or all on the\n"
+        "                                      sampler thread.\n";
     result.append(HELP_COMMAND_MSG);
 }
 } // namespace PowerMgr
@@ -156,6 +156,10 @@ void BatteryStatsListener::ProcessCameraEvent(StatsUtils::StatsData& data, const
         }
     } else if (eventName == StatsHiSysEvent::FLASHLIGHT_ON || eventName == StatsHiSysEvent::FLASHLIGHT_OFF) {
         data.type = StatsUtils::STATS_TYPE_CAMERA_FLASHLIGHT_ON;
+        cJSON* idItem = cJSON_GetObjectItemCaseSensitive(root, "ID");
+        if (StatsJsonUtils::IsValidJsonStringAndNoEmpty(idItem)) {
+            data.deviceId = idItem->valuestring;
+        }
         if (eventName == StatsHiSysEvent::FLASHLIGHT_ON) {
             data.state = StatsUtils::STATS_STATE_ACTIVATED;
         } else {
@@ -119,9 +119,40 @@ bool BatteryStatsParser::LoadAveragePowerFromFile(const std::string& path)
         }
     }
     cJSON_Delete(root);
+    BuildCpuCoefficients();
     return true;
 }
 
+void BatteryStatsParser::BuildCpuCoefficients()
+{
+    cpuActiveCoefficientMa_ = GetAveragePowerMa(StatsUtils::CURRENT_CPU_ACTIVE);
+    cpuClusterCoefficientsMa_.clear();
+    cpuSpeedCoefficientsMa_.clear();
+    for (uint16_t i = 0; i < clusterNum_; i++) {
+        cpuClusterCoefficientsMa_.push_back(GetAveragePowerMa(StatsUtils::CURRENT_CPU_CLUSTER, i));
+        std::string speedType = StatsUtils::CURRENT_CPU_SPEED + std::to_string(i);
+        uint16_t speedNum = GetSpeedNum(i);
+        for (uint16_t j = 0; j < speedNum; j++) {
+            cpuSpeedCoefficientsMa_.push_back(GetAveragePowerMa(speedType, j));
+        }
+    }
+}
+
+double BatteryStatsParser::GetCpuActiveCoefficientMa() const
+{
+    return cpuActiveCoefficientMa_;
+}
+
+const std::vector<double>& BatteryStatsParser::GetCpuClusterCoefficientsMa() const
+{
+    return cpuClusterCoefficientsMa_;
+}
+
+const std::vector<double>& BatteryStatsParser::GetCpuSpeedCoefficientsMa() const
+{
+    return cpuSpeedCoefficientsMa_;
+}
+
 void BatteryStatsParser::ParsingArray(const std::string& type, const cJSON* array)
 {
     std::vector<double> listValues;
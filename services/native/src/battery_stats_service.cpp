@@ -153,6 +153,8 @@ bool BatteryStatsService::SubscribeCommonEvent()
     MatchingSkills matchingSkills;
     matchingSkills.AddEvent(CommonEventSupport::COMMON_EVENT_SHUTDOWN);
     matchingSkills.AddEvent(CommonEventSupport::COMMON_EVENT_BATTERY_CHANGED);
+    matchingSkills.AddEvent(CommonEventSupport::COMMON_EVENT_USER_ADDED);
+    matchingSkills.AddEvent(CommonEventSupport::COMMON_EVENT_USER_REMOVED);
     CommonEventSubscribeInfo subscribeInfo(matchingSkills);
     subscribeInfo.SetThreadMode(CommonEventSubscribeInfo::ThreadMode::COMMON);
     if (!subscriberPtr_) {
@@ -270,6 +272,60 @@ double BatteryStatsService::GetPartStatsPercent(const BatteryStatsInfo::Consumpt
     return core_->GetPartStatsPercent(type);
 }
 
+double BatteryStatsService::GetHistoryStatsMah(const BatteryStatsInfo::ConsumptionType& type, int32_t uid,
+    int64_t beginTimeMs, int64_t endTimeMs)
+{
+    std::lock_guard lock(mutex_);
+    if (!Permission::IsSystem()) {
+        lastError_ = StatsError::ERR_SYSTEM_API_DENIED;
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    core_->ComputePower();
+    return core_->GetHistoryMah(type, uid, beginTimeMs, endTimeMs);
+}
+
+BatteryStatsInfoList BatteryStatsService::GetTopConsumers(int32_t count)
+{
+    std::lock_guard lock(mutex_);
+    BatteryStatsInfoList statsInfoList = {};
+    if (!Permission::IsSystem()) {
+        lastError_ = StatsError::ERR_SYSTEM_API_DENIED;
+        return statsInfoList;
+    }
+    // Served from the heap as of the last calculation, the sampler calculates at least once per history bucket
+    statsInfoList = core_->GetTopConsumers(count);
+    return statsInfoList;
+}
+
+void BatteryStatsService::MarkLedger(const std::string& name)
+{
+    std::lock_guard lock(mutex_);
+    if (!Permission::IsSystem()) {
+        lastError_ = StatsError::ERR_SYSTEM_API_DENIED;
+        return;
+    }
+    if (!core_->MarkLedger(name)) {
+        lastError_ = StatsError::ERR_PARAM_INVALID;
+    }
+}
+
+double BatteryStatsService::GetLedgerStatsMah(const std::string& name, const BatteryStatsInfo::ConsumptionType& type,
+    int32_t uid)
+{
+    std::lock_guard lock(mutex_);
+    if (!Permission::IsSystem()) {
+        lastError_ = StatsError::ERR_SYSTEM_API_DENIED;
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    core_->ComputePower();
+    double ledgerStatsMah = StatsUtils::DEFAULT_VALUE;
+    if (!core_->GetLedgerMah(name, type, uid, ledgerStatsMah)) {
+        lastError_ = StatsError::ERR_PARAM_INVALID;
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    return ledgerStatsMah;
+}
+
 uint64_t BatteryStatsService::GetTotalTimeSecond(const StatsUtils::StatsType& statsType, const int32_t& uid)
 {
     if (!Permission::IsSystem()) {
@@ -325,7 +381,7 @@ void BatteryStatsService::SetOnBattery(bool isOnBattery)
     if (!Permission::IsSystem()) {
         return;
     }
-    StatsHelper::SetOnBattery(isOnBattery);
+    core_->SetOnBattery(isOnBattery);
 }
 
 std::string BatteryStatsService::ShellDump(const std::vector<std::string>& args, uint32_t argc)
@@ -421,6 +477,46 @@ int32_t BatteryStatsService::ShellDumpIpc(const std::vector<std::string>& args,
     return ERR_OK;
 }
 
+int32_t BatteryStatsService::GetHistoryStatsMahIpc(int32_t type, int32_t uid, int64_t beginTimeMs, int64_t endTimeMs,
+    double& historyStatsMah, int32_t& tempError)
+{
+    StatsXCollie statsXCollie("BatteryStatsService::GetHistoryStatsMahIpc", false);
+    historyStatsMah = GetHistoryStatsMah(static_cast<BatteryStatsInfo::ConsumptionType>(type), uid, beginTimeMs,
+        endTimeMs);
+    tempError = static_cast<int32_t>(lastError_);
+    lastError_ = StatsError::ERR_OK;
+    return ERR_OK;
+}
+
+int32_t BatteryStatsService::MarkLedgerIpc(const std::string& name, int32_t& tempError)
+{
+    StatsXCollie statsXCollie("BatteryStatsService::MarkLedgerIpc", false);
+    MarkLedger(name);
+    tempError = static_cast<int32_t>(lastError_);
+    lastError_ = StatsError::ERR_OK;
+    return ERR_OK;
+}
+
+int32_t BatteryStatsService::GetLedgerStatsMahIpc(const std::string& name, int32_t type, int32_t uid,
+    double& ledgerStatsMah, int32_t& tempError)
+{
+    StatsXCollie statsXCollie("BatteryStatsService::GetLedgerStatsMahIpc", false);
+    ledgerStatsMah = GetLedgerStatsMah(name, static_cast<BatteryStatsInfo::ConsumptionType>(type), uid);
+    tempError = static_cast<int32_t>(lastError_);
+    lastError_ = StatsError::ERR_OK;
+    return ERR_OK;
+}
+
+int32_t BatteryStatsService::GetTopConsumersIpc(int32_t count, ParcelableBatteryStatsList& topConsumers,
+    int32_t& tempError)
+{
+    StatsXCollie statsXCollie("BatteryStatsService::GetTopConsumersIpc", false);
+    topConsumers.statsList_ = GetTopConsumers(count);
+    tempError = static_cast<int32_t>(lastError_);
+    lastError_ = StatsError::ERR_OK;
+    return ERR_OK;
+}
+
 void BatteryStatsService::DestroyInstance()
 {
     std::lock_guard<std::mutex> lock(singletonMutex_);
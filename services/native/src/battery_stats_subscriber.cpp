@@ -25,6 +25,7 @@
 #include "battery_stats_service.h"
 #include "stats_helper.h"
 #include "stats_log.h"
+#include "stats_uid_interner.h"
 
 namespace OHOS {
 namespace PowerMgr {
@@ -55,10 +56,17 @@ void BatteryStatsSubscriber::OnReceiveEvent(const OHOS::EventFwk::CommonEventDat
         }
         if (pluggedType == static_cast<int32_t>(BatteryPluggedType::PLUGGED_TYPE_NONE) ||
             pluggedType == static_cast<int32_t>(BatteryPluggedType::PLUGGED_TYPE_BUTT)) {
-            StatsHelper::SetOnBattery(true);
+            if (!StatsHelper::IsOnBattery()) {
+                statsService->GetBatteryStatsCore()->MarkLedger(StatsLedger::LEDGER_UNPLUG);
+            }
+            statsService->GetBatteryStatsCore()->SetOnBattery(true);
         } else {
-            StatsHelper::SetOnBattery(false);
+            statsService->GetBatteryStatsCore()->SetOnBattery(false);
         }
+    } else if (action == OHOS::EventFwk::CommonEventSupport::COMMON_EVENT_USER_ADDED ||
+        action == OHOS::EventFwk::CommonEventSupport::COMMON_EVENT_USER_REMOVED) {
+        STATS_HILOGI(COMP_SVC, "Received %{public}s event", action.c_str());
+        StatsUidInterner::GetInstance().InvalidateUserIds();
     }
 }
 } // namespace PowerMgr
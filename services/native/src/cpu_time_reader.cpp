@@ -15,22 +15,44 @@
 
 #include "cpu_time_reader.h"
 
-#include <fstream>
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cinttypes>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
 #include "string_ex.h"
 
 #include "battery_stats_service.h"
 #include "stats_helper.h"
 #include "stats_log.h"
+#include "stats_uid_interner.h"
 #include "stats_utils.h"
 
 namespace OHOS {
 namespace PowerMgr {
 namespace {
-static const std::string UID_CPU_ACTIVE_TIME_FILE = "/proc/uid_concurrent_active_time";
-static const std::string UID_CPU_CLUSTER_TIME_FILE = "/proc/uid_concurrent_policy_time";
-static const std::string UID_CPU_FREQ_TIME_FILE = "/proc/uid_time_in_state";
-static const std::string UID_CPU_TIME_FILE = "/proc/uid_cputime/show_uid_stat";
+// Indexed by ProcFileId
+static const std::string PROC_FILE_NAMES[] = {
+    "uid_concurrent_active_time",
+    "uid_concurrent_policy_time",
+    "uid_time_in_state",
+    "uid_cputime/show_uid_stat",
+};
+static const std::string POLICY_PREFIX = "policy";
+constexpr size_t INITIAL_READ_BUFFER_SIZE = 64 * 1024;
+constexpr size_t MIN_READ_SPACE = 4 * 1024;
 } // namespace
+CpuTimeReader::~CpuTimeReader()
+{
+    StopStageWorkers();
+    CloseProcFiles();
+}
+
 bool CpuTimeReader::Init()
 {
     if (!UpdateCpuTime()) {
@@ -39,12 +61,142 @@ bool CpuTimeReader::Init()
     return true;
 }
 
+void CpuTimeReader::SetProcRoot(const std::string& procRoot)
+{
+    CloseProcFiles();
+    procRoot_ = procRoot;
+    pidReader_.SetProcRoot(procRoot);
+}
+
+void CpuTimeReader::SetParallelRead(bool parallelRead)
+{
+    if (parallelRead) {
+        StartStageWorkers();
+    } else {
+        StopStageWorkers();
+    }
+    parallelRead_ = parallelRead;
+}
+
+void CpuTimeReader::StartStageWorkers()
+{
+    std::lock_guard<std::mutex> lock(stageMutex_);
+    if (!stageWorkers_.empty()) {
+        return;
+    }
+    isStageStopping_ = false;
+    // A worker only stages the samples requested after it was started
+    uint64_t stageSeq = stageSeq_;
+    for (uint32_t i = 1; i < PROC_FILE_COUNT; i++) {
+        stageWorkers_.emplace_back([this, i, stageSeq] { RunStageWorker(static_cast<ProcFileId>(i), stageSeq); });
+    }
+}
+
+void CpuTimeReader::StopStageWorkers()
+{
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(stageMutex_);
+        isStageStopping_ = true;
+        workers.swap(stageWorkers_);
+    }
+    stageCond_.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void CpuTimeReader::RunStageWorker(ProcFileId id, uint64_t stagedSeq)
+{
+    std::unique_lock<std::mutex> lock(stageMutex_);
+    while (true) {
+        stageCond_.wait(lock, [this, &stagedSeq] { return isStageStopping_ || stageSeq_ != stagedSeq; });
+        if (isStageStopping_) {
+            return;
+        }
+        stagedSeq = stageSeq_;
+        lock.unlock();
+        StageProcFile(id);
+        lock.lock();
+        if (--pendingStageCount_ == 0) {
+            stagedCond_.notify_one();
+        }
+    }
+}
+
+std::string CpuTimeReader::GetProcFilePath(const std::string& name) const
+{
+    return procRoot_ + "/" + name;
+}
+
+uint32_t CpuTimeReader::GetUidIndex(int32_t uid)
+{
+    uint32_t index = StatsUidInterner::GetInstance().Intern(uid);
+    EnsureUidIndex(index);
+    return index;
+}
+
+void CpuTimeReader::EnsureUidIndex(uint32_t index)
+{
+    if (index >= activeTimes_.size()) {
+        size_t size = static_cast<size_t>(index) + 1;
+        activeTimes_.resize(size, StatsUtils::DEFAULT_VALUE);
+        weightedActiveTimes_.resize(size, StatsUtils::DEFAULT_VALUE);
+        clusterTimes_.resize(size);
+        uidTimes_.resize(size);
+        lastActiveTimes_.resize(size, StatsUtils::INVALID_VALUE);
+        lastWeightedActiveTimes_.resize(size, StatsUtils::DEFAULT_VALUE);
+        lastClusterTimes_.resize(size);
+        lastUidTimes_.resize(size);
+        hasFreqTime_.resize(size, 0);
+        hasLastFreqTime_.resize(size, 0);
+        freqTimes_.resize(size * GetFreqRowSize(), StatsUtils::DEFAULT_VALUE);
+        lastFreqTimes_.resize(size * GetFreqRowSize(), StatsUtils::DEFAULT_VALUE);
+    }
+}
+
+size_t CpuTimeReader::GetFreqRowSize() const
+{
+    return speedOffsets_.back();
+}
+
+void CpuTimeReader::UpdateFreqLayout(const std::shared_ptr<BatteryStatsParser>& parser)
+{
+    uint16_t clusterNum = parser->GetClusterNum();
+    bool isSame = speedOffsets_.size() == static_cast<size_t>(clusterNum) + 1;
+    for (uint16_t i = 0; isSame && i < clusterNum; i++) {
+        isSame = speedOffsets_[i + 1] - speedOffsets_[i] == parser->GetSpeedNum(i);
+    }
+    if (isSame) {
+        return;
+    }
+    // The layout only changes when the power profile does, rows of the old layout are dropped
+    speedOffsets_.assign(1, 0);
+    for (uint16_t i = 0; i < clusterNum; i++) {
+        speedOffsets_.push_back(speedOffsets_.back() + parser->GetSpeedNum(i));
+    }
+    size_t size = hasFreqTime_.size();
+    freqTimes_.assign(size * GetFreqRowSize(), StatsUtils::DEFAULT_VALUE);
+    lastFreqTimes_.assign(size * GetFreqRowSize(), StatsUtils::DEFAULT_VALUE);
+    std::fill(hasFreqTime_.begin(), hasFreqTime_.end(), 0);
+    std::fill(hasLastFreqTime_.begin(), hasLastFreqTime_.end(), 0);
+    // Every row has to be merged again to rebuild the last times
+    procFiles_[PROC_FILE_FREQ_TIME].lastRowOffsets.clear();
+    STATS_HILOGI(COMP_SVC, "Cpu freq layout of %{public}u clusters and %{public}zu speeds", clusterNum,
+        GetFreqRowSize());
+}
+
+bool CpuTimeReader::FindUidIndex(int32_t uid, uint32_t& index)
+{
+    return StatsUidInterner::GetInstance().Find(uid, index) && index < activeTimes_.size();
+}
+
 int64_t CpuTimeReader::GetUidCpuActiveTimeMs(int32_t uid)
 {
     int64_t cpuActiveTime = 0;
-    auto iter = activeTimeMap_.find(uid);
-    if (iter != activeTimeMap_.end()) {
-        cpuActiveTime = iter->second;
+    uint32_t index = 0;
+    if (FindUidIndex(uid, index)) {
+        cpuActiveTime = activeTimes_[index];
         STATS_HILOGD(COMP_SVC, "Get cpu active time: %{public}s for uid: %{public}d",
             std::to_string(cpuActiveTime).c_str(), uid);
     } else {
@@ -55,38 +207,89 @@ int64_t CpuTimeReader::GetUidCpuActiveTimeMs(int32_t uid)
 
 void CpuTimeReader::DumpInfo(std::string& result, int32_t uid)
 {
-    auto uidIter = lastUidTimeMap_.find(uid);
-    if (uidIter == lastUidTimeMap_.end()) {
+    uint32_t index = 0;
+    if (!FindUidIndex(uid, index) || lastUidTimes_[index].size() < 2) { // user and system time
         STATS_HILOGE(COMP_SVC, "No related CPU info for uid: %{public}d", uid);
         return;
     }
     std::string freqTime = "";
-    auto freqIter = lastFreqTimeMap_.find(uid);
-    if (freqIter != lastFreqTimeMap_.end()) {
-        for (auto timeIter = freqIter->second.begin(); timeIter != freqIter->second.end(); timeIter++) {
-            for (uint32_t i = 0; i < timeIter->second.size(); i++) {
-                freqTime.append(ToString(timeIter->second[i]))
-                    .append(" ");
-            }
+    if (hasLastFreqTime_[index]) {
+        const int64_t* lastFreqTime = lastFreqTimes_.data() + index * GetFreqRowSize();
+        for (size_t i = 0; i < GetFreqRowSize(); i++) {
+            freqTime.append(ToString(lastFreqTime[i]))
+                .append(" ");
         }
     }
+    const auto& uidTime = lastUidTimes_[index];
+    result.append("Cpu active time: ")
+        .append(ToString(activeTimes_[index]))
+        .append("ms, concurrency weighted=")
+        .append(ToString(weightedActiveTimes_[index]))
+        .append("ms\n");
     result.append("Total cpu time: userSpaceTime=")
-        .append(ToString(uidIter->second[0]))
+        .append(ToString(uidTime[0]))
         .append("ms, systemSpaceTime=")
-        .append(ToString(uidIter->second[1]))
+        .append(ToString(uidTime[1]))
         .append("ms\n")
         .append("Total cpu time per freq: ")
         .append(freqTime)
         .append("\n");
 }
 
+void CpuTimeReader::DumpReadInfo(std::string& result)
+{
+    int64_t totalReadTimeUs = 0;
+    for (const auto& file : procFiles_) {
+        totalReadTimeUs += file.readTimeUs;
+    }
+    result.append("Cpu proc file reads: ")
+        .append(parallelRead_ ? "parallel" : "sequential")
+        .append(", latency=")
+        .append(ToString(readLatencyUs_))
+        .append("us, sum of reads=")
+        .append(ToString(totalReadTimeUs))
+        .append("us, new uid rows=")
+        .append(ToString(newRowUids_.size()))
+        .append(", unchanged uid rows=")
+        .append(ToString(unchangedRowCount_))
+        .append("/")
+        .append(ToString(uidRowCount_))
+        .append("\n");
+    for (uint32_t i = 0; i < PROC_FILE_COUNT; i++) {
+        const auto& file = procFiles_[i];
+        result.append(PROC_FILE_NAMES[i])
+            .append(": size=")
+            .append(ToString(file.readBytes))
+            .append("B, readTime=")
+            .append(ToString(file.readTimeUs))
+            .append("us, opens=")
+            .append(ToString(file.openCount))
+            .append(", errors=")
+            .append(ToString(file.errorCount))
+            .append("\n");
+    }
+    if (usePidActiveTime_ || usePidUidTime_) {
+        pidReader_.DumpInfo(result);
+    }
+}
+
+int64_t CpuTimeReader::GetUidCpuWeightedActiveTimeMs(int32_t uid)
+{
+    uint32_t index = 0;
+    if (!FindUidIndex(uid, index)) {
+        STATS_HILOGD(COMP_SVC, "No cpu weighted active time found for uid: %{public}d, return 0", uid);
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    return weightedActiveTimes_[index];
+}
+
 int64_t CpuTimeReader::GetUidCpuClusterTimeMs(int32_t uid, uint32_t cluster)
 {
     int64_t cpuClusterTime = 0;
-    auto iter = clusterTimeMap_.find(uid);
-    if (iter != clusterTimeMap_.end()) {
-        auto cpuClusterTimeVector = iter->second;
-        if (cluster < cpuClusterTimeVector.size()) {
+    uint32_t index = 0;
+    if (FindUidIndex(uid, index) && !clusterTimes_[index].empty()) {
+        const auto& cpuClusterTimeVector = clusterTimes_[index];
+        if (cluster < cpuClusterTimeVector.size() / 2) { // The weighted times take the second half
             cpuClusterTime = cpuClusterTimeVector[cluster];
             STATS_HILOGD(COMP_SVC, "Get cpu cluster time: %{public}s of cluster: %{public}d",
                 std::to_string(cpuClusterTime).c_str(), cluster);
@@ -99,38 +302,76 @@ int64_t CpuTimeReader::GetUidCpuClusterTimeMs(int32_t uid, uint32_t cluster)
     return cpuClusterTime;
 }
 
+int64_t CpuTimeReader::GetUidCpuWeightedClusterTimeMs(int32_t uid, uint32_t cluster)
+{
+    uint32_t index = 0;
+    if (!FindUidIndex(uid, index) || cluster >= clusterTimes_[index].size() / 2) {
+        STATS_HILOGD(COMP_SVC, "No cpu weighted cluster time of cluster: %{public}d found for uid: %{public}d",
+            cluster, uid);
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    const auto& cpuClusterTimeVector = clusterTimes_[index];
+    return cpuClusterTimeVector[cpuClusterTimeVector.size() / 2 + cluster];
+}
+
 int64_t CpuTimeReader::GetUidCpuFreqTimeMs(int32_t uid, uint32_t cluster, uint32_t speed)
 {
-    int64_t cpuFreqTime = 0;
-    auto uidIter = freqTimeMap_.find(uid);
-    if (uidIter != freqTimeMap_.end()) {
-        auto cpuFreqTimeMap = uidIter->second;
-        auto clusterIter = cpuFreqTimeMap.find(cluster);
-        if (clusterIter != cpuFreqTimeMap.end()) {
-            auto cpuFreqTimeVector = clusterIter->second;
-            if (speed < cpuFreqTimeVector.size()) {
-                cpuFreqTime = cpuFreqTimeVector[speed];
-                STATS_HILOGD(COMP_SVC, "Get cpu freq time: %{public}s of speed: %{public}d",
-                    std::to_string(cpuFreqTime).c_str(), speed);
-            } else {
-                STATS_HILOGD(COMP_SVC, "No cpu freq time of speed: %{public}d found, return 0", speed);
-            }
-        } else {
-            STATS_HILOGD(COMP_SVC, "No cluster cpu freq time vector of cluster: %{public}d found, return 0",
-                cluster);
-        }
-    } else {
-        STATS_HILOGD(COMP_SVC, "No uid cpu freq time map found for uid: %{public}d, return 0", uid);
+    size_t speedNum = 0;
+    const int64_t* speedTimes = GetUidCpuFreqTimesMs(uid, cluster, speedNum);
+    if (speed >= speedNum) {
+        STATS_HILOGD(COMP_SVC, "No cpu freq time of cluster: %{public}u, speed: %{public}u for uid: %{public}d",
+            cluster, speed, uid);
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    return speedTimes[speed];
+}
+
+const int64_t* CpuTimeReader::GetUidCpuFreqTimesMs(int32_t uid, uint32_t cluster, size_t& speedNum)
+{
+    // Points into the matrix, valid until the next update
+    speedNum = 0;
+    uint32_t index = 0;
+    if (!FindUidIndex(uid, index) || !hasFreqTime_[index] || cluster + 1 >= speedOffsets_.size()) {
+        return nullptr;
     }
-    return cpuFreqTime;
+    speedNum = speedOffsets_[cluster + 1] - speedOffsets_[cluster];
+    return freqTimes_.data() + index * GetFreqRowSize() + speedOffsets_[cluster];
+}
+
+const int64_t* CpuTimeReader::GetFreqTimeMatrix(size_t& rowCount, size_t& rowSize)
+{
+    // One row per uid index, rows of uids without freq time are zero
+    rowCount = hasFreqTime_.size();
+    rowSize = GetFreqRowSize();
+    return freqTimes_.data();
+}
+
+const int64_t* CpuTimeReader::GetActiveTimeColumn(size_t& rowCount, bool isWeighted)
+{
+    // The columns are indexed by uid index too, uids without times have zero or empty rows
+    rowCount = activeTimes_.size();
+    return isWeighted ? weightedActiveTimes_.data() : activeTimes_.data();
+}
+
+const std::vector<int64_t>* CpuTimeReader::GetClusterTimeColumn(size_t& rowCount)
+{
+    // A row holds the raw cluster times followed by the weighted ones
+    rowCount = clusterTimes_.size();
+    return clusterTimes_.data();
+}
+
+const std::vector<int64_t>* CpuTimeReader::GetUidTimeColumn(size_t& rowCount)
+{
+    rowCount = uidTimes_.size();
+    return uidTimes_.data();
 }
 
 std::vector<int64_t> CpuTimeReader::GetUidCpuTimeMs(int32_t uid)
 {
     std::vector<int64_t> cpuTimeVec;
-    auto iter = uidTimeMap_.find(uid);
-    if (iter != uidTimeMap_.end()) {
-        cpuTimeVec = iter->second;
+    uint32_t index = 0;
+    if (FindUidIndex(uid, index) && !uidTimes_[index].empty()) {
+        cpuTimeVec = uidTimes_[index];
         STATS_HILOGD(COMP_SVC, "Get uid cpu time vector for uid: %{public}d, size: %{public}d", uid,
             static_cast<int32_t>(cpuTimeVec.size()));
     } else {
@@ -141,215 +382,578 @@ std::vector<int64_t> CpuTimeReader::GetUidCpuTimeMs(int32_t uid)
 
 bool CpuTimeReader::UpdateCpuTime()
 {
+    UpdateWakelockHolders();
+    // All files are staged first, the deltas are then merged on this thread in a fixed order
+    StageProcFiles();
+    // The cpu time of every process summed by uid stands in for the active time and the uid time the kernel
+    // does not provide, the files that are present are merged as usual
+    usePidActiveTime_ = !procFiles_[PROC_FILE_ACTIVE_TIME].isStaged;
+    usePidUidTime_ = !procFiles_[PROC_FILE_UID_TIME].isStaged;
+    ResolveRowUids();
+    uidRowCount_ = 0;
+    unchangedRowCount_ = 0;
+    // A failed merge leaves the rows after the failed one unmerged, so the next sample compares no row of the file.
+    // A missing file is skipped, its times just stay as they are
     bool result = true;
-    if (!ReadUidCpuClusterTime()) {
+    if ((usePidActiveTime_ || usePidUidTime_) && !ReadPidCpuTime()) {
+        STATS_HILOGW(COMP_SVC, "Read pid cpu time failed");
+        result = false;
+    }
+
+    if (procFiles_[PROC_FILE_CLUSTER_TIME].isStaged && !ReadUidCpuClusterTime()) {
         STATS_HILOGW(COMP_SVC, "Read uid cpu cluster time failed");
+        procFiles_[PROC_FILE_CLUSTER_TIME].rowOffsets.clear();
         result = false;
     }
 
-    if (!ReadUidCpuTime()) {
+    if (!usePidUidTime_ && !ReadUidCpuTime()) {
         STATS_HILOGW(COMP_SVC, "Read uid cpu time failed");
+        procFiles_[PROC_FILE_UID_TIME].rowOffsets.clear();
         result = false;
     }
 
-    if (!ReadUidCpuActiveTime()) {
+    if (!usePidActiveTime_ && !ReadUidCpuActiveTime()) {
         STATS_HILOGW(COMP_SVC, "Read uid cpu active time failed");
+        procFiles_[PROC_FILE_ACTIVE_TIME].rowOffsets.clear();
         result = false;
     }
 
-    if (!ReadUidCpuFreqTime()) {
+    if (procFiles_[PROC_FILE_FREQ_TIME].isStaged && !ReadUidCpuFreqTime()) {
         STATS_HILOGW(COMP_SVC, "Read uid cpu freq time failed");
+        procFiles_[PROC_FILE_FREQ_TIME].rowOffsets.clear();
         result = false;
     }
     return result;
 }
 
-bool CpuTimeReader::ReadUidCpuActiveTimeImpl(std::string& line, int32_t uid)
+void CpuTimeReader::UpdateWakelockHolders()
+{
+    wakelockHolders_.clear();
+    wakelockHoldTimeMs_ = 0;
+    auto core = BatteryStatsService::GetInstance()->GetBatteryStatsCore();
+    if (core == nullptr) {
+        wakelockCounts_ = 0;
+        return;
+    }
+    std::vector<int64_t> holdTimesMs;
+    core->GetWakelockHoldTimesMs(holdTimesMs);
+    for (uint32_t index = 0; index < holdTimesMs.size(); index++) {
+        int64_t lastHoldTimeMs = index < lastHoldTimesMs_.size() ? lastHoldTimesMs_[index] : 0;
+        // Hold times restart from zero after a reset
+        int64_t holdTimeMs = holdTimesMs[index] >= lastHoldTimeMs ? holdTimesMs[index] - lastHoldTimeMs :
+            holdTimesMs[index];
+        if (holdTimeMs > 0) {
+            wakelockHolders_.emplace_back(index, holdTimeMs);
+            wakelockHoldTimeMs_ += holdTimeMs;
+        }
+    }
+    lastHoldTimesMs_ = std::move(holdTimesMs);
+    wakelockCounts_ = static_cast<uint32_t>(wakelockHolders_.size());
+    STATS_HILOGD(COMP_SVC, "Wakelock holders: %{public}u, hold time: %{public}" PRId64 "ms", wakelockCounts_,
+        wakelockHoldTimeMs_);
+}
+
+int64_t CpuTimeReader::GetHolderShare(int64_t withheldTime, int64_t holdTimeBeforeMs, int64_t holdTimeMs) const
+{
+    // Shares are cut from the cumulative hold time, so they add up to the withheld time without rounding loss
+    double ratio = static_cast<double>(withheldTime) / wakelockHoldTimeMs_;
+    return static_cast<int64_t>(ratio * (holdTimeBeforeMs + holdTimeMs)) -
+        static_cast<int64_t>(ratio * holdTimeBeforeMs);
+}
+
+void CpuTimeReader::DistributeWithheldFreqTime()
+{
+    if (wakelockHoldTimeMs_ <= 0 || withheldFreqTimes_.empty()) {
+        return;
+    }
+    size_t rowSize = std::min(GetFreqRowSize(), withheldFreqTimes_.size());
+    int64_t holdTimeBeforeMs = 0;
+    for (const auto& [index, holdTimeMs] : wakelockHolders_) {
+        EnsureUidIndex(index);
+        int64_t* freqTime = freqTimes_.data() + index * GetFreqRowSize();
+        for (size_t offset = 0; offset < rowSize; offset++) {
+            freqTime[offset] += GetHolderShare(withheldFreqTimes_[offset], holdTimeBeforeMs, holdTimeMs);
+        }
+        hasFreqTime_[index] = 1;
+        holdTimeBeforeMs += holdTimeMs;
+    }
+}
+
+void CpuTimeReader::DistributeWithheldUidTime()
+{
+    if (wakelockHoldTimeMs_ <= 0 || withheldUidTimes_.empty()) {
+        return;
+    }
+    int64_t holdTimeBeforeMs = 0;
+    for (const auto& [index, holdTimeMs] : wakelockHolders_) {
+        EnsureUidIndex(index);
+        auto& uidTime = uidTimes_[index];
+        uidTime.resize(UID_TIME_COUNT, StatsUtils::DEFAULT_VALUE);
+        for (size_t i = 0; i < UID_TIME_COUNT; i++) {
+            uidTime[i] += GetHolderShare(withheldUidTimes_[i], holdTimeBeforeMs, holdTimeMs);
+        }
+        holdTimeBeforeMs += holdTimeMs;
+    }
+}
+
+class CpuTimeReader::ProcScanner {
+public:
+    void Reset(const char* begin, const char* end)
+    {
+        cur_ = begin;
+        end_ = end;
+    }
+
+    bool AtEnd() const
+    {
+        return cur_ >= end_;
+    }
+
+    const char* GetPosition() const
+    {
+        return cur_;
+    }
+
+    void NextLine()
+    {
+        const void* newline = memchr(cur_, '\n', end_ - cur_);
+        cur_ = newline == nullptr ? end_ : static_cast<const char*>(newline) + 1;
+    }
+
+    bool StartsWith(const std::string& prefix) const
+    {
+        return static_cast<size_t>(end_ - cur_) >= prefix.size() && memcmp(cur_, prefix.data(), prefix.size()) == 0;
+    }
+
+    bool Expect(char expected)
+    {
+        SkipBlanks();
+        if (cur_ < end_ && *cur_ == expected) {
+            cur_++;
+            return true;
+        }
+        return false;
+    }
+
+    // Numbers never span lines, so a failed parse also marks the end of the current line
+    bool ParseInt(int64_t& value)
+    {
+        SkipBlanks();
+        auto [ptr, ec] = std::from_chars(cur_, end_, value);
+        if (ec != std::errc()) {
+            return false;
+        }
+        cur_ = ptr;
+        return true;
+    }
+
+    bool SkipToken()
+    {
+        SkipBlanks();
+        const char* start = cur_;
+        while (cur_ < end_ && !IsBlank(*cur_) && *cur_ != '\n') {
+            cur_++;
+        }
+        return cur_ != start;
+    }
+
+    // Parses "<uid>:" at the start of a line, header lines have no uid
+    bool ParseUid(int32_t& uid)
+    {
+        int64_t value = 0;
+        if (!ParseInt(value) || !Expect(':') || value <= StatsUtils::INVALID_VALUE || value > INT32_MAX) {
+            return false;
+        }
+        uid = static_cast<int32_t>(value);
+        return true;
+    }
+
+private:
+    static bool IsBlank(char c)
+    {
+        return c == ' ' || c == '\t';
+    }
+
+    void SkipBlanks()
+    {
+        while (cur_ < end_ && IsBlank(*cur_)) {
+            cur_++;
+        }
+    }
+
+    const char* cur_ = nullptr;
+    const char* end_ = nullptr;
+};
+
+bool CpuTimeReader::OpenProcFile(ProcFileId id)
+{
+    auto& file = procFiles_[id];
+    file.fd = open(GetProcFilePath(PROC_FILE_NAMES[id]).c_str(), O_RDONLY | O_CLOEXEC);
+    if (file.fd < 0) {
+        STATS_HILOGW(COMP_SVC, "Open file failed, errno: %{public}d", errno);
+        return false;
+    }
+    file.openCount++;
+    return true;
+}
+
+void CpuTimeReader::CloseProcFiles()
+{
+    for (auto& file : procFiles_) {
+        if (file.fd >= 0) {
+            close(file.fd);
+            file.fd = -1;
+        }
+    }
+}
+
+bool CpuTimeReader::ReadProcFile(ProcFileId id, size_t& size)
 {
-    int64_t timeMs = 0;
-    std::vector<std::string> splitedTime;
-    Split(line, ' ', splitedTime);
-    for (uint16_t i = 0; i < splitedTime.size(); i++) {
-        int64_t result = 0;
-        if (!StatsUtils::ParseStrtollResult(splitedTime[i], result)) {
+    // The whole file is read from offset 0 into a buffer that only ever grows, the scanner then parses it in place
+    auto& file = procFiles_[id];
+    auto& buffer = file.buffer;
+    size = 0;
+    while (true) {
+        if (buffer.size() - size < MIN_READ_SPACE) {
+            buffer.resize(std::max(buffer.size() * 2, INITIAL_READ_BUFFER_SIZE));
+        }
+        ssize_t count = pread(file.fd, buffer.data() + size, buffer.size() - size, static_cast<off_t>(size));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            STATS_HILOGW(COMP_SVC, "Read file failed, errno: %{public}d", errno);
+            return false;
+        }
+        if (count == 0) {
+            return true;
+        }
+        size += static_cast<size_t>(count);
+    }
+}
+
+bool CpuTimeReader::StageProcFile(ProcFileId id)
+{
+    // Only touches the entry of this file, so the files of one sample can be staged concurrently
+    auto& file = procFiles_[id];
+    // The content of the last sample moves aside, every row can then be compared with the same row of it
+    std::swap(file.buffer, file.lastBuffer);
+    std::swap(file.rowOffsets, file.lastRowOffsets);
+    file.isStaged = ReadStagedProcFile(id);
+    if (!file.isStaged) {
+        std::swap(file.buffer, file.lastBuffer);
+        std::swap(file.rowOffsets, file.lastRowOffsets);
+        return false;
+    }
+    ScanRows(file);
+    return true;
+}
+
+bool CpuTimeReader::ReadStagedProcFile(ProcFileId id)
+{
+    auto& file = procFiles_[id];
+    auto begin = std::chrono::steady_clock::now();
+    bool opened = false;
+    if (file.fd < 0) {
+        if (!OpenProcFile(id)) {
+            return false;
+        }
+        opened = true;
+    }
+    size_t size = 0;
+    bool isRead = ReadProcFile(id, size);
+    if (!isRead && !opened) {
+        // A descriptor kept from an earlier sample may have gone stale, reopen it once
+        file.errorCount++;
+        close(file.fd);
+        isRead = OpenProcFile(id) && ReadProcFile(id, size);
+    }
+    if (!isRead) {
+        file.errorCount++;
+        if (file.fd >= 0) {
+            close(file.fd);
+            file.fd = -1;
+        }
+        return false;
+    }
+    file.readTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    file.readBytes = size;
+    return true;
+}
+
+void CpuTimeReader::ScanRows(ProcFile& file)
+{
+    file.rowUids.clear();
+    file.rowOffsets.clear();
+    const char* begin = file.buffer.data();
+    ProcScanner scanner;
+    scanner.Reset(begin, begin + file.readBytes);
+    for (; !scanner.AtEnd(); scanner.NextLine()) {
+        file.rowOffsets.push_back(static_cast<uint32_t>(scanner.GetPosition() - begin));
+        int32_t uid = StatsUtils::INVALID_VALUE;
+        scanner.ParseUid(uid);
+        file.rowUids.push_back(uid);
+    }
+    file.rowOffsets.push_back(static_cast<uint32_t>(file.readBytes));
+}
+
+void CpuTimeReader::ResolveRowUids()
+{
+    // The files list the same uids in the same order until apps come or go, so most samples resolve no row,
+    // and the rows that moved are interned with a single lock of the interner
+    newRowUids_.clear();
+    newRows_.clear();
+    for (uint32_t id = 0; id < PROC_FILE_COUNT; id++) {
+        auto& file = procFiles_[id];
+        const auto& rowUids = file.rowUids;
+        auto& indexedRowUids = file.indexedRowUids;
+        if (!file.isStaged || (rowUids.size() == indexedRowUids.size() &&
+            memcmp(rowUids.data(), indexedRowUids.data(), rowUids.size() * sizeof(int32_t)) == 0)) {
             continue;
         }
-        timeMs += result * 10; // Unit is 10ms
+        file.rowIndexes.resize(rowUids.size());
+        for (size_t row = 0; row < rowUids.size(); row++) {
+            bool isResolved = row < indexedRowUids.size() && indexedRowUids[row] == rowUids[row];
+            if (!isResolved && rowUids[row] != StatsUtils::INVALID_VALUE) {
+                newRowUids_.push_back(rowUids[row]);
+                newRows_.emplace_back(id, row);
+            }
+        }
+        indexedRowUids.assign(rowUids.begin(), rowUids.end());
+    }
+    if (newRowUids_.empty()) {
+        return;
+    }
+    newRowIndexes_.resize(newRowUids_.size());
+    StatsUidInterner::GetInstance().InternBatch(newRowUids_.data(), newRowUids_.size(), newRowIndexes_.data());
+    uint32_t maxIndex = 0;
+    for (size_t i = 0; i < newRows_.size(); i++) {
+        procFiles_[newRows_[i].first].rowIndexes[newRows_[i].second] = newRowIndexes_[i];
+        maxIndex = std::max(maxIndex, newRowIndexes_[i]);
+    }
+    EnsureUidIndex(maxIndex);
+}
+
+uint32_t CpuTimeReader::GetRowUidIndex(ProcFileId id, size_t row) const
+{
+    return procFiles_[id].rowIndexes[row];
+}
+
+bool CpuTimeReader::IsRowUnchanged(ProcFileId id, size_t row)
+{
+    // Counters only grow, so a uid row with the same bytes as in the last sample has nothing to add
+    const auto& file = procFiles_[id];
+    if (file.rowUids[row] == StatsUtils::INVALID_VALUE) {
+        return false;
+    }
+    uidRowCount_++;
+    if (row + 1 >= file.lastRowOffsets.size()) {
+        return false;
+    }
+    uint32_t size = file.rowOffsets[row + 1] - file.rowOffsets[row];
+    if (size != file.lastRowOffsets[row + 1] - file.lastRowOffsets[row] ||
+        memcmp(file.buffer.data() + file.rowOffsets[row], file.lastBuffer.data() + file.lastRowOffsets[row],
+        size) != 0) {
+        return false;
+    }
+    unchangedRowCount_++;
+    return true;
+}
+
+void CpuTimeReader::StageProcFiles()
+{
+    auto begin = std::chrono::steady_clock::now();
+    if (parallelRead_) {
+        // The kernel generates every file on read, so the slowest one bounds the sample instead of their sum
+        {
+            std::lock_guard<std::mutex> lock(stageMutex_);
+            stageSeq_++;
+            pendingStageCount_ = static_cast<uint32_t>(stageWorkers_.size());
+        }
+        stageCond_.notify_all();
+        StageProcFile(static_cast<ProcFileId>(0));
+        std::unique_lock<std::mutex> lock(stageMutex_);
+        stagedCond_.wait(lock, [this] { return pendingStageCount_ == 0; });
+    } else {
+        for (uint32_t i = 0; i < PROC_FILE_COUNT; i++) {
+            StageProcFile(static_cast<ProcFileId>(i));
+        }
+    }
+    readLatencyUs_ = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+}
+
+bool CpuTimeReader::OpenProcScanner(ProcFileId id, ProcScanner& scanner)
+{
+    auto& file = procFiles_[id];
+    if (!file.isStaged) {
+        return false;
     }
+    scanner.Reset(file.buffer.data(), file.buffer.data() + file.readBytes);
+    return true;
+}
 
+bool CpuTimeReader::UpdateUidCpuActiveTime(int64_t timeMs, int64_t weightedTimeMs, uint32_t index)
+{
     int64_t increment = 0;
+    int64_t weightedIncrement = 0;
     if (timeMs > 0) {
-        auto iterLast = lastActiveTimeMap_.find(uid);
-        if (iterLast != lastActiveTimeMap_.end()) {
-            increment = timeMs - iterLast->second;
+        int64_t& lastTimeMs = lastActiveTimes_[index];
+        int64_t& lastWeightedTimeMs = lastWeightedActiveTimes_[index];
+        if (lastTimeMs > StatsUtils::INVALID_VALUE) {
+            increment = timeMs - lastTimeMs;
             if (increment >= 0) {
-                iterLast->second = timeMs;
+                lastTimeMs = timeMs;
             } else {
                 STATS_HILOGI(COMP_SVC, "Negative cpu active time increment");
                 return false;
             }
+            weightedIncrement = weightedTimeMs - lastWeightedTimeMs;
         } else {
-            lastActiveTimeMap_.insert(std::pair<int32_t, int64_t>(uid, timeMs));
+            lastTimeMs = timeMs;
             increment = timeMs;
+            weightedIncrement = weightedTimeMs;
         }
+        lastWeightedTimeMs = weightedTimeMs;
     }
 
     if (StatsHelper::IsOnBattery()) {
         STATS_HILOGD(COMP_SVC, "Power supply is not connected. Add the increment");
-        auto iter = activeTimeMap_.find(uid);
-        if (iter != activeTimeMap_.end()) {
-            iter->second += increment;
-        } else {
-            activeTimeMap_.insert(std::pair<int32_t, int64_t>(uid, increment));
-            STATS_HILOGI(COMP_SVC, "Add active time: %{public}sms, uid: %{public}d",
-                std::to_string(increment).c_str(), uid);
-        }
+        activeTimes_[index] += increment;
+        weightedActiveTimes_[index] += weightedIncrement;
     }
     return true;
 }
 
+void CpuTimeReader::ParseConcurrencyTimes(ProcScanner& scanner)
+{
+    concurrencyTimes_.clear();
+    int64_t value = 0;
+    while (scanner.ParseInt(value)) {
+        concurrencyTimes_.push_back(value);
+    }
+}
+
+void CpuTimeReader::SumConcurrencyTimes(const int64_t* times, size_t count, int64_t& timeMs,
+    int64_t& weightedTimeMs)
+{
+    // times[n - 1] is the time spent with n cpus active, both sums are taken in one pass without branches
+    for (size_t i = concurrencyWeights_.size(); i < count; i++) {
+        concurrencyWeights_.push_back(1.0 / static_cast<double>(i + 1));
+    }
+    const double* weights = concurrencyWeights_.data();
+    int64_t time = 0;
+    double weightedTime = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        time += times[i];
+        weightedTime += static_cast<double>(times[i]) * weights[i];
+    }
+    // Both are derived from the cumulative counters, so truncating the weighted time does not add up over samples
+    timeMs = time * 10; // Unit is 10ms
+    weightedTimeMs = static_cast<int64_t>(weightedTime * 10);
+}
+
 bool CpuTimeReader::ReadUidCpuActiveTime()
 {
-    std::ifstream input(UID_CPU_ACTIVE_TIME_FILE);
-    if (!input) {
-        STATS_HILOGW(COMP_SVC, "Open file failed");
+    ProcScanner scanner;
+    if (!OpenProcScanner(PROC_FILE_ACTIVE_TIME, scanner)) {
         return false;
     }
 
-    std::string line;
-    const int32_t INDEX_0 = 0;
-    const int32_t INDEX_1 = 1;
-    while (getline(input, line)) {
-        int32_t uid = StatsUtils::INVALID_VALUE;
-        std::vector<std::string> splitedLine;
-        Split(line, ':', splitedLine);
-        if (splitedLine[INDEX_0] == "cpus") {
+    for (size_t row = 0; !scanner.AtEnd(); scanner.NextLine(), row++) {
+        if (IsRowUnchanged(PROC_FILE_ACTIVE_TIME, row)) {
             continue;
-        } else {
-            int64_t result = 0;
-            if (!StatsUtils::ParseStrtollResult(splitedLine[INDEX_0], result)) {
-                continue;
-            }
-            uid = static_cast<int32_t>(result);
-        }
-
-        if (uid > StatsUtils::INVALID_VALUE) {
-            auto bss = BatteryStatsService::GetInstance();
-            auto uidEntity =
-                bss->GetBatteryStatsCore()->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
-            if (uidEntity) {
-                uidEntity->UpdateUidMap(uid);
-            }
         }
-
-        if (ReadUidCpuActiveTimeImpl(splitedLine[INDEX_1], uid)) {
+        int32_t uid = StatsUtils::INVALID_VALUE;
+        if (!scanner.ParseUid(uid)) {
             continue;
-        } else {
+        }
+        int64_t timeMs = 0;
+        int64_t weightedTimeMs = 0;
+        ParseConcurrencyTimes(scanner);
+        SumConcurrencyTimes(concurrencyTimes_.data(), concurrencyTimes_.size(), timeMs, weightedTimeMs);
+        if (!UpdateUidCpuActiveTime(timeMs, weightedTimeMs, GetRowUidIndex(PROC_FILE_ACTIVE_TIME, row))) {
             return false;
         }
     }
     return true;
 }
 
-void CpuTimeReader::ReadPolicy(std::vector<uint16_t>& clusters, std::string& line)
+void CpuTimeReader::ReadPolicy(ProcScanner& scanner)
 {
-    std::vector<std::string> splitedPolicy;
-    Split(line, ' ', splitedPolicy);
-    uint32_t step = 2;
-    for (uint32_t i = 0; i < splitedPolicy.size(); i += step) {
-        int64_t result = 0;
-        if (!StatsUtils::ParseStrtollResult(splitedPolicy[i + 1], result)) {
-            continue;
-        }
-        uint16_t coreNum = static_cast<uint16_t>(result);
-        clusters.push_back(coreNum);
-        clustersMap_.insert(std::pair<uint16_t, uint16_t>(i, coreNum));
+    // Every cluster name is followed by its number of cores, e.g. "policy0: 4 policy4: 3"
+    int64_t coreNum = 0;
+    while (scanner.SkipToken() && scanner.ParseInt(coreNum)) {
+        clusters_.push_back(static_cast<uint16_t>(coreNum));
     }
 }
 
-bool CpuTimeReader::ReadClusterTimeIncrement(std::vector<int64_t>& clusterTime, std::vector<int64_t>& increments,
-    int32_t uid, std::vector<uint16_t>& clusters, std::string& timeLine)
+bool CpuTimeReader::ReadClusterTimeIncrement(ProcScanner& scanner, uint32_t index)
 {
-    std::vector<std::string> splitedTime;
-    Split(timeLine, ' ', splitedTime);
-    uint16_t count = 0;
-    for (uint16_t i = 0; i < clusters.size(); i++) {
-        int64_t tempTimeMs = 0;
-        for (uint16_t j = 0; j < clusters[i]; j++) {
-            int64_t result = 0;
-            if (!StatsUtils::ParseStrtollResult(splitedTime[count++], result)) {
-                continue;
-            }
-            tempTimeMs += result * 10; // Unit is 10ms
-        }
-        clusterTime.push_back(tempTimeMs);
+    // Every cluster has one time per number of its cores active, as laid out by the policy line
+    size_t clusterNum = clusters_.size();
+    clusterTime_.assign(clusterNum * 2, 0);
+    ParseConcurrencyTimes(scanner);
+    size_t offset = 0;
+    for (size_t i = 0; i < clusterNum && offset < concurrencyTimes_.size(); i++) {
+        size_t count = std::min<size_t>(clusters_[i], concurrencyTimes_.size() - offset);
+        SumConcurrencyTimes(concurrencyTimes_.data() + offset, count, clusterTime_[i], clusterTime_[clusterNum + i]);
+        offset += count;
     }
 
-    auto iterLast = lastClusterTimeMap_.find(uid);
-    if (iterLast != lastClusterTimeMap_.end()) {
-        for (uint16_t i = 0; i < clusters.size(); i++) {
-            int64_t increment = clusterTime[i] - iterLast->second[i];
+    auto& lastClusterTime = lastClusterTimes_[index];
+    if (!lastClusterTime.empty()) {
+        clusterIncrements_.resize(clusterTime_.size());
+        for (size_t i = 0; i < clusterTime_.size() && i < lastClusterTime.size(); i++) {
+            int64_t increment = clusterTime_[i] - lastClusterTime[i];
             if (increment >= 0) {
-                iterLast->second[i] = clusterTime[i];
-                increments.push_back(increment);
+                lastClusterTime[i] = clusterTime_[i];
+                clusterIncrements_[i] = increment;
             } else {
                 STATS_HILOGD(COMP_SVC, "Negative cpu cluster time increment");
                 return false;
             }
         }
     } else {
-        lastClusterTimeMap_.insert(std::pair<int32_t, std::vector<int64_t>>(uid, clusterTime));
-        increments = clusterTime;
-        STATS_HILOGI(COMP_SVC, "Add last cpu cluster time for uid: %{public}d", uid);
+        lastClusterTime = clusterTime_;
+        clusterIncrements_ = clusterTime_;
+        STATS_HILOGI(COMP_SVC, "Add last cpu cluster time for uid index: %{public}u", index);
     }
     return true;
 }
 
 bool CpuTimeReader::ReadUidCpuClusterTime()
 {
-    std::ifstream input(UID_CPU_CLUSTER_TIME_FILE);
-    if (!input) {
-        STATS_HILOGW(COMP_SVC, "Open file failed");
+    ProcScanner scanner;
+    if (!OpenProcScanner(PROC_FILE_CLUSTER_TIME, scanner)) {
         return false;
     }
-    std::string line;
-    int32_t uid = -1;
-    std::vector<uint16_t> clusters;
-    std::vector<int64_t> clusterTime;
-    while (getline(input, line)) {
-        clusterTime.clear();
-        if (line.find("policy") != line.npos) {
-            ReadPolicy(clusters, line);
+    clusters_.clear();
+    for (size_t row = 0; !scanner.AtEnd(); scanner.NextLine(), row++) {
+        if (scanner.StartsWith(POLICY_PREFIX)) {
+            ReadPolicy(scanner);
             continue;
         }
-
-        std::vector<std::string> splitedLine;
-        Split(line, ':', splitedLine);
-        int64_t result = 0;
-        if (!StatsUtils::ParseStrtollResult(splitedLine[0], result)) {
+        if (IsRowUnchanged(PROC_FILE_CLUSTER_TIME, row)) {
             continue;
         }
-        uid = static_cast<int32_t>(result);
-        if (uid > StatsUtils::INVALID_VALUE) {
-            auto bss = BatteryStatsService::GetInstance();
-            auto uidEntity = bss->GetBatteryStatsCore()->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
-            if (uidEntity) {
-                uidEntity->UpdateUidMap(uid);
-            }
-        }
 
-        std::vector<int64_t> increments;
-        if (!ReadClusterTimeIncrement(clusterTime, increments, uid, clusters, splitedLine[1])) {
+        int32_t uid = StatsUtils::INVALID_VALUE;
+        if (!scanner.ParseUid(uid)) {
+            continue;
+        }
+        uint32_t index = GetRowUidIndex(PROC_FILE_CLUSTER_TIME, row);
+        if (!ReadClusterTimeIncrement(scanner, index)) {
             return false;
         }
 
         if (StatsHelper::IsOnBattery()) {
             STATS_HILOGD(COMP_SVC, "Power supply is not connected. Add the increment");
-            auto iter = clusterTimeMap_.find(uid);
-            if (iter != clusterTimeMap_.end()) {
-                AddIncrementsToClusterTime(iter->second, increments, clusters);
+            if (!clusterTimes_[index].empty()) {
+                AddIncrementsToClusterTime(clusterTimes_[index], clusterIncrements_);
             } else {
-                clusterTimeMap_.insert(std::pair<int32_t, std::vector<int64_t>>(uid, increments));
+                clusterTimes_[index] = clusterIncrements_;
                 STATS_HILOGI(COMP_SVC, "Add cpu cluster time for uid: %{public}d", uid);
             }
         }
@@ -358,268 +962,224 @@ bool CpuTimeReader::ReadUidCpuClusterTime()
 }
 
 void CpuTimeReader::AddIncrementsToClusterTime(std::vector<int64_t>& clusterTime,
-    const std::vector<int64_t>& increments, const std::vector<uint16_t>& clusters)
+    const std::vector<int64_t>& increments)
 {
-    for (uint16_t i = 0; i < clusters.size(); i++) {
+    for (size_t i = 0; i < clusterTime.size() && i < increments.size(); i++) {
         clusterTime[i] += increments[i];
     }
 }
 
-bool CpuTimeReader::ProcessFreqTime(std::map<uint32_t, std::vector<int64_t>>& map, std::map<uint32_t,
-    std::vector<int64_t>>& increments, std::map<uint32_t, std::vector<int64_t>>& speedTime, int32_t index, int32_t uid)
-{
-    auto iterLastTemp = map.find(index);
-    if (iterLastTemp != map.end()) {
-        std::vector<int64_t> lastSpeedTimes = iterLastTemp->second;
-        std::vector<int64_t> newIncrementTimes;
-        newIncrementTimes.clear();
-        for (uint16_t j = 0; j < lastSpeedTimes.size(); j++) {
-            int64_t increment = speedTime.at(index)[j] - lastSpeedTimes[j];
-            if (increment >= 0) {
-                newIncrementTimes.push_back(increment);
-                increments.insert(std::pair<uint32_t, std::vector<int64_t>>(index, newIncrementTimes));
-            } else {
-                STATS_HILOGI(COMP_SVC, "Negative cpu freq time increment");
-                return false;
-            }
-        }
-        iterLastTemp->second = speedTime.at(index);
-    }
-    return true;
-}
-
-bool CpuTimeReader::ReadFreqTimeIncrement(std::map<uint32_t, std::vector<int64_t>>& speedTime,
-    std::map<uint32_t, std::vector<int64_t>>& increments, int32_t uid, std::vector<std::string>& splitedTime)
+bool CpuTimeReader::ReadFreqTimeIncrement(uint32_t index)
 {
-    auto bss = BatteryStatsService::GetInstance();
-    auto parser = bss->GetBatteryStatsParser();
-    uint16_t clusterNum = parser->GetClusterNum();
-    uint16_t count = 0;
-    for (uint16_t i = 0; i < clusterNum; i++) {
-        std::vector<int64_t> tempSpeedTimes;
-        tempSpeedTimes.clear();
-        for (uint16_t j = 0; j < parser->GetSpeedNum(i); j++) {
-            int64_t result = 0;
-            if (!StatsUtils::ParseStrtollResult(splitedTime[count++], result)) {
-                continue;
-            }
-            int64_t tempTimeMs = result * 10; // Unit is 10ms
-            tempSpeedTimes.push_back(tempTimeMs);
-        }
-        speedTime.insert(std::pair<uint32_t, std::vector<int64_t>>(i, tempSpeedTimes));
-    }
-
-    auto iterLast = lastFreqTimeMap_.find(uid);
-    if (iterLast == lastFreqTimeMap_.end()) {
-        lastFreqTimeMap_.insert(std::pair<int32_t, std::map<uint32_t, std::vector<int64_t>>>(uid, speedTime));
-        increments = speedTime;
-        STATS_HILOGI(COMP_SVC, "Add last cpu freq time for uid: %{public}d", uid);
+    size_t rowSize = GetFreqRowSize();
+    int64_t* lastFreqTime = lastFreqTimes_.data() + index * rowSize;
+    if (!hasLastFreqTime_[index]) {
+        std::copy(freqTime_.begin(), freqTime_.end(), lastFreqTime);
+        freqIncrements_ = freqTime_;
+        hasLastFreqTime_[index] = 1;
+        STATS_HILOGI(COMP_SVC, "Add last cpu freq time for uid index: %{public}u", index);
         return true;
     }
-    for (uint16_t i = 0; i < lastFreqTimeMap_.size(); i++) {
-        if (!ProcessFreqTime(iterLast->second, increments, speedTime, i, uid)) {
+    for (size_t offset = 0; offset < rowSize; offset++) {
+        int64_t increment = freqTime_[offset] - lastFreqTime[offset];
+        if (increment < 0) {
+            STATS_HILOGI(COMP_SVC, "Negative cpu freq time increment");
             return false;
         }
+        freqIncrements_[offset] = increment;
+        lastFreqTime[offset] = freqTime_[offset];
     }
     return true;
 }
 
-void CpuTimeReader::DistributeFreqTime(std::map<uint32_t, std::vector<int64_t>>& uidIncrements,
-    std::map<uint32_t, std::vector<int64_t>>& increments)
+void CpuTimeReader::DistributeFreqTime()
 {
-    auto bss = BatteryStatsService::GetInstance();
-    auto parser = bss->GetBatteryStatsParser();
-    uint16_t clusterNum = parser->GetClusterNum();
+    freqUidIncrements_ = freqIncrements_;
     if (wakelockCounts_ > 0) {
-        for (uint16_t i = 0; i < clusterNum; i++) {
-            uint16_t speedNum = parser->GetSpeedNum(i);
-            for (uint16_t j = 0; j < speedNum; j++) {
-                int32_t step = 2;
-                uidIncrements.at(i)[j] = increments.at(i)[j] / step;
-            }
+        for (size_t offset = 0; offset < freqIncrements_.size(); offset++) {
+            int32_t step = 2;
+            freqUidIncrements_[offset] = freqIncrements_[offset] / step;
+            withheldFreqTimes_[offset] += freqIncrements_[offset] - freqUidIncrements_[offset];
         }
-        // TO-DO, distribute half of cpu freq time to wakelock holders
     }
 }
 
-void CpuTimeReader::AddFreqTimeToUid(std::map<uint32_t, std::vector<int64_t>>& uidIncrements, int32_t uid)
+void CpuTimeReader::AddFreqTimeToUid(uint32_t index)
 {
-    auto bss = BatteryStatsService::GetInstance();
-    auto parser = bss->GetBatteryStatsParser();
-    uint16_t clusterNum = parser->GetClusterNum();
-    auto iter = freqTimeMap_.find(uid);
-    if (iter != freqTimeMap_.end()) {
-        for (uint16_t i = 0; i < clusterNum; i++) {
-            uint16_t speedNum = parser->GetSpeedNum(i);
-            for (uint16_t j = 0; j < speedNum; j++) {
-                iter->second.at(i)[j] += uidIncrements.at(i)[j];
-            }
-        }
-    } else {
-        freqTimeMap_.insert(std::pair<int32_t, std::map<uint32_t, std::vector<int64_t>>>(uid, uidIncrements));
-        STATS_HILOGI(COMP_SVC, "Add cpu freq time for uid: %{public}d", uid);
+    if (!hasFreqTime_[index]) {
+        hasFreqTime_[index] = 1;
+        STATS_HILOGI(COMP_SVC, "Add cpu freq time for uid index: %{public}u", index);
+    }
+    int64_t* freqTime = freqTimes_.data() + index * GetFreqRowSize();
+    for (size_t offset = 0; offset < freqUidIncrements_.size(); offset++) {
+        freqTime[offset] += freqUidIncrements_[offset];
     }
 }
 
 bool CpuTimeReader::ReadUidCpuFreqTime()
 {
-    std::ifstream input(UID_CPU_FREQ_TIME_FILE);
-    if (!input) {
-        STATS_HILOGW(COMP_SVC, "Open file failed");
+    ProcScanner scanner;
+    if (!OpenProcScanner(PROC_FILE_FREQ_TIME, scanner)) {
         return false;
     }
-    std::string line;
-    int32_t uid = -1;
-    std::map<uint32_t, std::vector<int64_t>> speedTime;
-    while (getline(input, line)) {
-        speedTime.clear();
-        std::vector<std::string> splitedLine;
-        Split(line, ':', splitedLine);
-        if (splitedLine[0] == "uid") {
+    UpdateFreqLayout(BatteryStatsService::GetInstance()->GetBatteryStatsParser());
+    size_t speedCount = GetFreqRowSize();
+    freqTime_.resize(speedCount);
+    freqIncrements_.resize(speedCount);
+    if (wakelockCounts_ > 0) {
+        withheldFreqTimes_.assign(speedCount, StatsUtils::DEFAULT_VALUE);
+    } else {
+        withheldFreqTimes_.clear();
+    }
+
+    for (size_t row = 0; !scanner.AtEnd(); scanner.NextLine(), row++) {
+        if (IsRowUnchanged(PROC_FILE_FREQ_TIME, row)) {
             continue;
-        } else {
-            int64_t result = 0;
-            if (!StatsUtils::ParseStrtollResult(splitedLine[0], result)) {
-                continue;
-            }
-            uid = static_cast<int32_t>(result);
-        }
-        if (uid > StatsUtils::INVALID_VALUE) {
-            auto bss = BatteryStatsService::GetInstance();
-            auto uidEntity =
-                bss->GetBatteryStatsCore()->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
-            if (uidEntity) {
-                uidEntity->UpdateUidMap(uid);
-            }
         }
-        std::vector<std::string> splitedTime;
-        Split(splitedLine[1], ' ', splitedTime);
-
-        std::map<uint32_t, std::vector<int64_t>> increments;
-        if (!ReadFreqTimeIncrement(speedTime, increments, uid, splitedTime)) {
+        // The "uid:" header lists the frequencies and has no uid
+        int32_t uid = StatsUtils::INVALID_VALUE;
+        if (!scanner.ParseUid(uid)) {
+            continue;
+        }
+        size_t count = 0;
+        int64_t value = 0;
+        while (count < speedCount && scanner.ParseInt(value)) {
+            freqTime_[count++] = value * 10; // Unit is 10ms
+        }
+        if (count < speedCount) {
+            STATS_HILOGD(COMP_SVC, "Incomplete cpu freq time of uid: %{public}d", uid);
+            continue;
+        }
+        uint32_t index = GetRowUidIndex(PROC_FILE_FREQ_TIME, row);
+        if (!ReadFreqTimeIncrement(index)) {
             return false;
         }
-
-        std::map<uint32_t, std::vector<int64_t>> uidIncrements = increments;
-        DistributeFreqTime(uidIncrements, increments);
+        DistributeFreqTime();
 
         if (!StatsHelper::IsOnBattery()) {
             STATS_HILOGD(COMP_SVC, "Power supply is connected, don't add the increment");
             continue;
         }
-        AddFreqTimeToUid(uidIncrements, uid);
+        AddFreqTimeToUid(index);
+    }
+    if (StatsHelper::IsOnBattery()) {
+        DistributeWithheldFreqTime();
     }
     return true;
 }
 
-bool CpuTimeReader::ReadUidTimeIncrement(std::vector<int64_t>& cpuTime, std::vector<int64_t>& uidIncrements,
-    int32_t uid, std::string& timeLine)
+bool CpuTimeReader::ReadUidTimeIncrement(const UidTime& cpuTime, UidTime& uidIncrements, uint32_t index)
 {
-    std::vector<std::string> splitedTime;
-    Split(timeLine, ' ', splitedTime);
-    for (uint16_t i = 0; i < splitedTime.size(); i++) {
-        int64_t tempTime = 0;
-        int64_t result = 0;
-        if (!StatsUtils::ParseStrtollResult(splitedTime[i], result)) {
-            continue;
-        }
-        tempTime = result;
-        cpuTime.push_back(tempTime);
-    }
-
-    std::vector<int64_t> increments;
-    auto iterLast = lastUidTimeMap_.find(uid);
-    if (iterLast != lastUidTimeMap_.end()) {
-        for (uint16_t i = 0; i < splitedTime.size(); i++) {
-            int64_t increment = 0;
-            increment = cpuTime[i] - iterLast->second[i];
+    UidTime increments;
+    auto& lastUidTime = lastUidTimes_[index];
+    if (!lastUidTime.empty()) {
+        for (size_t i = 0; i < UID_TIME_COUNT; i++) {
+            int64_t increment = cpuTime[i] - lastUidTime[i];
             if (increment >= 0) {
-                iterLast->second[i] = cpuTime[i];
-                increments.push_back(increment);
+                lastUidTime[i] = cpuTime[i];
+                increments[i] = increment;
             } else {
                 STATS_HILOGI(COMP_SVC, "Negative cpu time increment");
                 return false;
             }
         }
     } else {
-        lastUidTimeMap_.insert(std::pair<int32_t, std::vector<int64_t>>(uid, cpuTime));
+        lastUidTime.assign(cpuTime.begin(), cpuTime.end());
         increments = cpuTime;
-        STATS_HILOGI(COMP_SVC, "Add last cpu time for uid: %{public}d", uid);
+        STATS_HILOGI(COMP_SVC, "Add last cpu time for uid index: %{public}u", index);
     }
 
-    uidIncrements = increments;
+    for (size_t i = 0; i < UID_TIME_COUNT; i++) {
+        uidIncrements[i] = increments[i] / StatsUtils::US_IN_MS;
+    }
 
     if (wakelockCounts_ > 0) {
         double weight = 0.5;
-        uidIncrements[0] = increments[0] / (StatsUtils::US_IN_MS * 1.0) * weight;
-        uidIncrements[1] = increments[1] / (StatsUtils::US_IN_MS * 1.0) * weight;
-        // TO-DO, distribute half of cpu time to wakelock holders
+        for (size_t i = 0; i < UID_TIME_COUNT; i++) {
+            int64_t incrementMs = uidIncrements[i];
+            uidIncrements[i] = static_cast<int64_t>(incrementMs * weight);
+            withheldUidTimes_[i] += incrementMs - uidIncrements[i];
+        }
     }
     return true;
 }
 
 bool CpuTimeReader::ReadUidCpuTime()
 {
-    std::ifstream input(UID_CPU_TIME_FILE);
-    if (!input) {
-        STATS_HILOGW(COMP_SVC, "Open file failed");
+    ProcScanner scanner;
+    if (!OpenProcScanner(PROC_FILE_UID_TIME, scanner)) {
         return false;
     }
-    std::string line;
-    std::vector<int64_t> cpuTime;
-    while (getline(input, line)) {
-        cpuTime.clear();
-        std::vector<std::string> splitedLine;
-        Split(line, ':', splitedLine);
-        int64_t result = 0;
-        if (!StatsUtils::ParseStrtollResult(splitedLine[0], result)) {
+    withheldUidTimes_.assign(UID_TIME_COUNT, StatsUtils::DEFAULT_VALUE);
+    for (size_t row = 0; !scanner.AtEnd(); scanner.NextLine(), row++) {
+        if (IsRowUnchanged(PROC_FILE_UID_TIME, row)) {
+            // The uid time holds the increment of the last sample, which is none
+            if (StatsHelper::IsOnBattery()) {
+                UpdateUidTime(GetRowUidIndex(PROC_FILE_UID_TIME, row), UidTime {});
+            }
             continue;
         }
-        int32_t uid = static_cast<int32_t>(result);
-        if (uid > StatsUtils::INVALID_VALUE) {
-            auto bss = BatteryStatsService::GetInstance();
-            auto uidEntity =
-                bss->GetBatteryStatsCore()->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
-            if (uidEntity) {
-                uidEntity->UpdateUidMap(uid);
-            }
+        int32_t uid = StatsUtils::INVALID_VALUE;
+        if (!scanner.ParseUid(uid)) {
+            continue;
+        }
+        // User and system time in us
+        UidTime cpuTime {};
+        size_t count = 0;
+        while (count < UID_TIME_COUNT && scanner.ParseInt(cpuTime[count])) {
+            count++;
         }
+        if (count < UID_TIME_COUNT) {
+            continue;
+        }
+        uint32_t index = GetRowUidIndex(PROC_FILE_UID_TIME, row);
 
-        std::vector<int64_t> uidIncrements;
-        if (!ReadUidTimeIncrement(cpuTime, uidIncrements, uid, splitedLine[1])) {
+        UidTime uidIncrements {};
+        if (!ReadUidTimeIncrement(cpuTime, uidIncrements, index)) {
             return false;
         }
 
         if (StatsHelper::IsOnBattery()) {
             STATS_HILOGD(COMP_SVC, "Power supply is not connected. Add the increment");
-            UpdateUidTimeMap(uid, uidIncrements);
+            UpdateUidTime(index, uidIncrements);
         }
     }
+    if (StatsHelper::IsOnBattery()) {
+        DistributeWithheldUidTime();
+    }
     return true;
 }
 
-void CpuTimeReader::UpdateUidTimeMap(int32_t uid, const std::vector<int64_t>& uidIncrements)
+bool CpuTimeReader::ReadPidCpuTime()
 {
-    auto iter = uidTimeMap_.find(uid);
-    if (iter != uidTimeMap_.end()) {
-        for (uint16_t i = 0; i < uidIncrements.size(); i++) {
-            iter->second[i] = uidIncrements[i];
+    if (!pidReader_.Scan()) {
+        return false;
+    }
+    // Process time is all the fallback knows of, it counts as the active time, the uid time or both
+    for (const auto& [uid, cpuTime] : pidReader_.GetUidIncrements()) {
+        uint32_t index = GetUidIndex(uid);
+        if (!StatsHelper::IsOnBattery()) {
+            continue;
+        }
+        if (usePidActiveTime_) {
+            activeTimes_[index] += cpuTime.userTimeMs + cpuTime.systemTimeMs;
+            // Without concurrency times every process counts as running alone
+            weightedActiveTimes_[index] += cpuTime.userTimeMs + cpuTime.systemTimeMs;
+        }
+        if (usePidUidTime_) {
+            UpdateUidTime(index, { cpuTime.userTimeMs, cpuTime.systemTimeMs });
         }
-    } else {
-        uidTimeMap_.insert(std::pair<int32_t, std::vector<int64_t>>(uid, uidIncrements));
-        STATS_HILOGI(COMP_SVC, "Add cpu time for uid: %{public}d", uid);
     }
+    return true;
 }
 
-void CpuTimeReader::Split(std::string &origin, char delimiter, std::vector<std::string> &splited)
+void CpuTimeReader::UpdateUidTime(uint32_t index, const UidTime& uidIncrements)
 {
-    size_t start;
-    size_t end = 0;
-
-    while ((start = origin.find_first_not_of(delimiter, end)) != std::string::npos) {
-        end = origin.find(delimiter, start);
-        splited.push_back(origin.substr(start, end - start));
+    auto& uidTime = uidTimes_[index];
+    if (uidTime.empty()) {
+        STATS_HILOGI(COMP_SVC, "Add cpu time for uid index: %{public}u", index);
     }
+    uidTime.assign(uidIncrements.begin(), uidIncrements.end());
 }
 } // namespace PowerMgr
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
@@ -33,54 +33,32 @@ AudioEntity::AudioEntity()
 int64_t AudioEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsType, int16_t level)
 {
     int64_t activeTimeMs = StatsUtils::DEFAULT_VALUE;
-    switch (statsType) {
-        case StatsUtils::STATS_TYPE_AUDIO_ON: {
-            auto iter = audioTimerMap_.find(uid);
-            if (iter != audioTimerMap_.end()) {
-                activeTimeMs = iter->second->GetRunningTimeMs();
-                STATS_HILOGD(COMP_SVC, "Get audio on time: %{public}" PRId64 "ms for uid: %{public}d",
-                    activeTimeMs, uid);
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "Didn't find related timer for uid: %{public}d, return 0", uid);
-            break;
-        }
-        default:
-            break;
+    if (statsType != StatsUtils::STATS_TYPE_AUDIO_ON) {
+        return activeTimeMs;
     }
+
+    activeTimeMs = GetTimerStore().GetRunningTimeMs(StatsTimerStore::TIMER_KIND_AUDIO_ON, uid);
+    STATS_HILOGD(COMP_SVC, "Get audio on time: %{public}" PRId64 "ms for uid: %{public}d", activeTimeMs, uid);
     return activeTimeMs;
 }
 
 void AudioEntity::Calculate(int32_t uid)
 {
     auto bss = BatteryStatsService::GetInstance();
-    auto audioOnAverageMa = bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_AUDIO_ON);
+    auto audioOnAverageMa =
+        bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_AUDIO_ON);
     auto audioOnTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_AUDIO_ON);
     auto audioOnPowerMah = audioOnAverageMa * audioOnTimeMs / StatsUtils::MS_IN_HOUR;
-    auto iter = audioPowerMap_.find(uid);
-    if (iter != audioPowerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Update audio on power consumption: %{public}lfmAh for uid: %{public}d",
-            audioOnAverageMa, uid);
-        iter->second = audioOnPowerMah;
-    } else {
-        STATS_HILOGD(COMP_SVC, "Create audio on power consumption: %{public}lfmAh for uid: %{public}d",
-            audioOnPowerMah, uid);
-        audioPowerMap_.insert(std::pair<int32_t, double>(uid, audioOnPowerMah));
-    }
+    STATS_HILOGD(COMP_SVC, "Update audio on power consumption: %{public}lfmAh for uid: %{public}d",
+        audioOnPowerMah, uid);
+    GetTimerStore().SetPowerMah(StatsTimerStore::TIMER_KIND_AUDIO_ON, uid, audioOnPowerMah);
 }
 
 double AudioEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
-    double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = audioPowerMap_.find(uidOrUserId);
-    if (iter != audioPowerMap_.end()) {
-        power = iter->second;
-        STATS_HILOGD(COMP_SVC, "Get app audio power consumption: %{public}lfmAh for uid: %{public}d",
-            power, uidOrUserId);
-    } else {
-        STATS_HILOGD(COMP_SVC,
-            "No app audio power consumption related to uid: %{public}d was found, return 0", uidOrUserId);
-    }
+    double power = GetTimerStore().GetPowerMah(StatsTimerStore::TIMER_KIND_AUDIO_ON, uidOrUserId);
+    STATS_HILOGD(COMP_SVC, "Get app audio power consumption: %{public}lfmAh for uid: %{public}d",
+        power, uidOrUserId);
     return power;
 }
 
@@ -88,15 +66,9 @@ double AudioEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t ui
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_AUDIO_ON) {
-        auto audioOnIter = audioPowerMap_.find(uid);
-        if (audioOnIter != audioPowerMap_.end()) {
-            power = audioOnIter->second;
-            STATS_HILOGD(COMP_SVC, "Get audio on power consumption: %{public}lfmAh for uid: %{public}d",
-                power, uid);
-        } else {
-            STATS_HILOGD(COMP_SVC,
-                "No audio on power consumption related to uid: %{public}d was found, return 0", uid);
-        }
+        power = GetTimerStore().GetPowerMah(StatsTimerStore::TIMER_KIND_AUDIO_ON, uid);
+        STATS_HILOGD(COMP_SVC, "Get audio on power consumption: %{public}lfmAh for uid: %{public}d",
+            power, uid);
     }
     return power;
 }
@@ -104,41 +76,17 @@ double AudioEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t ui
 std::shared_ptr<StatsHelper::ActiveTimer> AudioEntity::GetOrCreateTimer(int32_t uid, StatsUtils::StatsType statsType,
     int16_t level)
 {
-    std::shared_ptr<StatsHelper::ActiveTimer> timer = nullptr;
-    switch (statsType) {
-        case StatsUtils::STATS_TYPE_AUDIO_ON: {
-            auto audioOnIter = audioTimerMap_.find(uid);
-            if (audioOnIter != audioTimerMap_.end()) {
-                STATS_HILOGD(COMP_SVC, "Get audio on timer for uid: %{public}d", uid);
-                timer = audioOnIter->second;
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "Create audio on timer for uid: %{public}d", uid);
-            std::shared_ptr<StatsHelper::ActiveTimer> audioTimer = std::make_shared<StatsHelper::ActiveTimer>();
-            audioTimerMap_.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, audioTimer));
-            timer = audioTimer;
-            break;
-        }
-        default:
-            STATS_HILOGW(COMP_SVC, "Create active timer failed");
-            break;
+    if (statsType != StatsUtils::STATS_TYPE_AUDIO_ON) {
+        return nullptr;
     }
-    return timer;
+    STATS_HILOGD(COMP_SVC, "Get audio on timer for uid: %{public}d", uid);
+    return GetTimerStore().GetTimer(StatsTimerStore::TIMER_KIND_AUDIO_ON, uid);
 }
 
 void AudioEntity::Reset()
 {
-    // Reset app Audio on total power consumption
-    for (auto& iter : audioPowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
-
-    // Reset Audio on timer
-    for (auto& iter : audioTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
+    // Reset app Audio on timer and power consumption
+    GetTimerStore().Reset(StatsTimerStore::TIMER_KIND_AUDIO_ON);
 }
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file
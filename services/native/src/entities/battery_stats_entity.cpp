@@ -19,7 +19,9 @@
 namespace OHOS {
 namespace PowerMgr {
 double BatteryStatsEntity::totalPowerMah_ = StatsUtils::DEFAULT_VALUE;
-BatteryStatsInfoList BatteryStatsEntity::statsInfoList_;
+StatsResultTable BatteryStatsEntity::statsResults_;
+StatsTimerStore BatteryStatsEntity::timerStore_;
+std::shared_ptr<StatsArena> BatteryStatsEntity::statsArena_;
 
 void BatteryStatsEntity::AggregateUserPowerMah(int32_t userId, double power)
 {
@@ -45,12 +47,55 @@ int64_t BatteryStatsEntity::GetConsumptionCount(StatsUtils::StatsType statsType,
 
 BatteryStatsInfoList BatteryStatsEntity::GetStatsInfoList()
 {
-    return statsInfoList_;
+    BatteryStatsInfoList statsInfoList;
+    for (const auto& record : statsResults_) {
+        std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
+        statsInfo->SetConsumptioType(record.type);
+        statsInfo->SetUid(record.uid);
+        statsInfo->SetUserId(record.userId);
+        statsInfo->SetPower(record.powerMah);
+        statsInfoList.push_back(statsInfo);
+    }
+    return statsInfoList;
 }
 
-void BatteryStatsEntity::UpdateStatsInfoList(std::shared_ptr<BatteryStatsInfo> info)
+const StatsResultTable& BatteryStatsEntity::GetStatsResults()
 {
-    statsInfoList_.push_back(info);
+    return statsResults_;
+}
+
+void BatteryStatsEntity::AddStatsResult(BatteryStatsInfo::ConsumptionType type, double powerMah, int32_t uid,
+    int32_t userId)
+{
+    statsResults_.push_back({type, uid, userId, powerMah});
+}
+
+StatsTimerStore& BatteryStatsEntity::GetTimerStore()
+{
+    return timerStore_;
+}
+
+void BatteryStatsEntity::SetStatsArena(const std::shared_ptr<StatsArena>& arena)
+{
+    statsArena_ = arena;
+}
+
+std::shared_ptr<StatsHelper::ActiveTimer> BatteryStatsEntity::AllocateTimer()
+{
+    if (statsArena_ == nullptr) {
+        STATS_HILOGW(COMP_SVC, "Stats arena is not set, allocate timer from heap");
+        return std::make_shared<StatsHelper::ActiveTimer>();
+    }
+    return statsArena_->AllocateTimer();
+}
+
+std::shared_ptr<StatsHelper::Counter> BatteryStatsEntity::AllocateCounter()
+{
+    if (statsArena_ == nullptr) {
+        STATS_HILOGW(COMP_SVC, "Stats arena is not set, allocate counter from heap");
+        return std::make_shared<StatsHelper::Counter>();
+    }
+    return statsArena_->AllocateCounter();
 }
 
 int64_t BatteryStatsEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsType, int16_t level)
@@ -93,6 +138,11 @@ void BatteryStatsEntity::UpdateCpuTime()
     STATS_HILOGE(COMP_SVC, "No need to update cpu time");
 }
 
+void BatteryStatsEntity::SetParallelRead(bool parallelRead)
+{
+    STATS_HILOGE(COMP_SVC, "No need to set parallel read");
+}
+
 double BatteryStatsEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid)
 {
     STATS_HILOGE(COMP_SVC, "No need to get stats power, return 0");
@@ -141,7 +191,8 @@ void BatteryStatsEntity::ResetStatsEntity()
 {
     STATS_HILOGI(COMP_SVC, "Reset total consumption power and battery stats list");
     totalPowerMah_ = StatsUtils::DEFAULT_VALUE;
-    statsInfoList_.clear();
+    // Keep the capacity, so a recompute does not allocate again
+    statsResults_.clear();
 }
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file
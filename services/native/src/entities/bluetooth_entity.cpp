@@ -70,10 +70,7 @@ void BluetoothEntity::CalculateBtPower()
     bluetoothPowerMah_ = bluetoothBrOnPowerMah + bluetoothBleOnPowerMah + bluetoothUidPowerMah;
     totalPowerMah_ += bluetoothPowerMah_;
 
-    std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-    statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_BLUETOOTH);
-    statsInfo->SetPower(bluetoothPowerMah_);
-    statsInfoList_.push_back(statsInfo);
+    AddStatsResult(BatteryStatsInfo::CONSUMPTION_TYPE_BLUETOOTH, bluetoothPowerMah_);
 
     STATS_HILOGD(COMP_SVC, "Calculate bluetooth Br time: %{public}" PRId64 "ms, Br power average: %{public}lfma,"    \
         "Br power consumption: %{public}lfmAh, bluetooth Ble time: %{public}" PRId64 "ms, "                          \
@@ -97,17 +94,16 @@ void BluetoothEntity::CalculateBtPowerForApp(int32_t uid)
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_BLUETOOTH_BR_SCAN);
     auto bluetoothBrScanTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN);
     auto bluetoothBrScanPowerMah = bluetoothBrScanTimeMs * bluetoothBrScanAverageMa / StatsUtils::MS_IN_HOUR;
-    UpdateAppBluetoothBlePower(POWER_TYPE_BR, uid, bluetoothBrScanPowerMah);
+    GetTimerStore().SetPowerMah(StatsTimerStore::TIMER_KIND_BLUETOOTH_BR_SCAN, uid, bluetoothBrScanPowerMah);
 
     // Calculate Bluetooth Ble scan power consumption
     auto bluetoothBleScanAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_BLUETOOTH_BLE_SCAN);
     auto bluetoothBleScanTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN);
     auto bluetoothBleScanPowerMah = bluetoothBleScanTimeMs * bluetoothBleScanAverageMa / StatsUtils::MS_IN_HOUR;
-    UpdateAppBluetoothBlePower(POWER_TYPE_BLE, uid, bluetoothBleScanPowerMah);
+    GetTimerStore().SetPowerMah(StatsTimerStore::TIMER_KIND_BLUETOOTH_BLE_SCAN, uid, bluetoothBleScanPowerMah);
 
     auto bluetoothUidPowerMah = bluetoothBrScanPowerMah + bluetoothBleScanPowerMah;
-    UpdateAppBluetoothBlePower(POWER_TYPE_ALL, uid, bluetoothUidPowerMah);
 
     STATS_HILOGD(COMP_SVC, "Calculate bluetooth Br scan time: %{public}" PRId64 "ms, "                         \
         "Br scan power average: %{public}lfma, Br scan power consumption: %{public}lfmAh "                     \
@@ -123,77 +119,20 @@ void BluetoothEntity::CalculateBtPowerForApp(int32_t uid)
         uid);
 }
 
-void BluetoothEntity::UpdateAppBluetoothBlePower(PowerType type, int32_t uid, double powerMah)
-{
-    switch (type) {
-        case POWER_TYPE_BR: {
-            auto iter = appBluetoothBrPowerMap_.find(uid);
-            if (iter != appBluetoothBrPowerMap_.end()) {
-                iter->second = powerMah;
-                STATS_HILOGD(COMP_SVC, "Update app bluetooth Br power consumption: %{public}lfmAh for uid: %{public}d",
-                    powerMah, uid);
-                break;
-            }
-            appBluetoothBrPowerMap_.insert(std::pair<int32_t, double>(uid, powerMah));
-            STATS_HILOGD(COMP_SVC, "Create app bluetooth Br power consumption: %{public}lfmAh for uid: %{public}d",
-                powerMah, uid);
-            break;
-        }
-        case POWER_TYPE_BLE: {
-            auto iter = appBluetoothBlePowerMap_.find(uid);
-            if (iter != appBluetoothBlePowerMap_.end()) {
-                iter->second = powerMah;
-                STATS_HILOGD(COMP_SVC, "Update app bluetooth Ble power consumption: %{public}lfmAh for uid: %{public}d",
-                    powerMah, uid);
-                break;
-            }
-            appBluetoothBlePowerMap_.insert(std::pair<int32_t, double>(uid, powerMah));
-            STATS_HILOGD(COMP_SVC, "Create app bluetooth Ble power consumption: %{public}lfmAh for uid: %{public}d",
-                powerMah, uid);
-            break;
-        }
-        case POWER_TYPE_ALL: {
-            auto iter = appBluetoothPowerMap_.find(uid);
-            if (iter != appBluetoothPowerMap_.end()) {
-                iter->second = powerMah;
-                STATS_HILOGD(COMP_SVC, "Update app bluetooth power consumption: %{public}lfmAh for uid: %{public}d",
-                    powerMah, uid);
-                break;
-            }
-            appBluetoothPowerMap_.insert(std::pair<int32_t, double>(uid, powerMah));
-            STATS_HILOGD(COMP_SVC, "Create app bluetooth power consumption: %{public}lfmAh for uid: %{public}d",
-                powerMah, uid);
-            break;
-        }
-        default:
-            break;
-    }
-}
-
 int64_t BluetoothEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsType, int16_t level)
 {
     int64_t time = StatsUtils::DEFAULT_VALUE;
     switch (statsType) {
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN: {
-            auto brScanIter = appBluetoothBrScanTimerMap_.find(uid);
-            if (brScanIter != appBluetoothBrScanTimerMap_.end()) {
-                time = brScanIter->second->GetRunningTimeMs();
-                STATS_HILOGD(COMP_SVC, "Get blueooth Br scan time: %{public}" PRId64 "ms for uid: %{public}d",
-                    time, uid);
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "No bluetooth Br scan timer related to uid: %{public}d was found, return 0", uid);
+            time = GetTimerStore().GetRunningTimeMs(StatsTimerStore::TIMER_KIND_BLUETOOTH_BR_SCAN, uid);
+            STATS_HILOGD(COMP_SVC, "Get blueooth Br scan time: %{public}" PRId64 "ms for uid: %{public}d",
+                time, uid);
             break;
         }
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN: {
-            auto bleScanIter = appBluetoothBleScanTimerMap_.find(uid);
-            if (bleScanIter != appBluetoothBleScanTimerMap_.end()) {
-                time = bleScanIter->second->GetRunningTimeMs();
-                STATS_HILOGD(COMP_SVC, "Get blueooth Ble scan time: %{public}" PRId64 "ms for uid: %{public}d",
-                    time, uid);
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "No bluetooth Ble scan timer related to uid: %{public}d was found, return 0", uid);
+            time = GetTimerStore().GetRunningTimeMs(StatsTimerStore::TIMER_KIND_BLUETOOTH_BLE_SCAN, uid);
+            STATS_HILOGD(COMP_SVC, "Get blueooth Ble scan time: %{public}" PRId64 "ms for uid: %{public}d",
+                time, uid);
             break;
         }
         default:
@@ -234,15 +173,11 @@ double BluetoothEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (uidOrUserId > StatsUtils::INVALID_VALUE) {
-        auto iter = appBluetoothPowerMap_.find(uidOrUserId);
-        if (iter != appBluetoothPowerMap_.end()) {
-            power = iter->second;
-            STATS_HILOGD(COMP_SVC, "Get app blueooth power consumption: %{public}lfmAh for uid: %{public}d",
-                power, uidOrUserId);
-        } else {
-            STATS_HILOGD(COMP_SVC,
-                "No app blueooth power consumption related to uid: %{public}d was found, return 0", uidOrUserId);
-        }
+        auto& timerStore = GetTimerStore();
+        power = timerStore.GetPowerMah(StatsTimerStore::TIMER_KIND_BLUETOOTH_BR_SCAN, uidOrUserId) +
+            timerStore.GetPowerMah(StatsTimerStore::TIMER_KIND_BLUETOOTH_BLE_SCAN, uidOrUserId);
+        STATS_HILOGD(COMP_SVC, "Get app blueooth power consumption: %{public}lfmAh for uid: %{public}d",
+            power, uidOrUserId);
     } else {
         power = bluetoothPowerMah_;
         STATS_HILOGD(COMP_SVC, "Get blueooth power consumption: %{public}lfmAh", power);
@@ -265,27 +200,15 @@ double BluetoothEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_
             break;
         }
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN: {
-            auto brIter = appBluetoothBrPowerMap_.find(uid);
-            if (brIter != appBluetoothBrPowerMap_.end()) {
-                power = brIter->second;
-                STATS_HILOGD(COMP_SVC, "Get blueooth Br scan power consumption: %{public}lfmAh for uid: %{public}d",
-                    power, uid);
-                break;
-            }
-            STATS_HILOGD(COMP_SVC,
-                "No bluetooth Br scan power consumption related to uid: %{public}d was found, return 0", uid);
+            power = GetTimerStore().GetPowerMah(StatsTimerStore::TIMER_KIND_BLUETOOTH_BR_SCAN, uid);
+            STATS_HILOGD(COMP_SVC, "Get blueooth Br scan power consumption: %{public}lfmAh for uid: %{public}d",
+                power, uid);
             break;
         }
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN: {
-            auto bleIter = appBluetoothBlePowerMap_.find(uid);
-            if (bleIter != appBluetoothBlePowerMap_.end()) {
-                power = bleIter->second;
-                STATS_HILOGD(COMP_SVC, "Get blueooth Ble scan power consumption: %{public}lfmAh for uid: %{public}d",
-                    power, uid);
-                break;
-            }
-            STATS_HILOGD(COMP_SVC,
-                "No bluetooth Ble scan power consumption related to uid: %{public}d was found, return 0", uid);
+            power = GetTimerStore().GetPowerMah(StatsTimerStore::TIMER_KIND_BLUETOOTH_BLE_SCAN, uid);
+            STATS_HILOGD(COMP_SVC, "Get blueooth Ble scan power consumption: %{public}lfmAh for uid: %{public}d",
+                power, uid);
             break;
         }
         default:
@@ -308,31 +231,9 @@ void BluetoothEntity::Reset()
         bluetoothBleOnTimer_->Reset();
     }
 
-    // Reset app Bluetooth scan power consumption
-    for (auto& iter : appBluetoothBrPowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
-
-    for (auto& iter : appBluetoothBlePowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
-
-    for (auto& iter : appBluetoothPowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
-
-    // Reset Bluetooth scan timer
-    for (auto& iter : appBluetoothBrScanTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
-
-    for (auto& iter : appBluetoothBleScanTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
+    // Reset app Bluetooth scan timer and power consumption
+    GetTimerStore().Reset(StatsTimerStore::TIMER_KIND_BLUETOOTH_BR_SCAN);
+    GetTimerStore().Reset(StatsTimerStore::TIMER_KIND_BLUETOOTH_BLE_SCAN);
 }
 
 std::shared_ptr<StatsHelper::ActiveTimer> BluetoothEntity::GetOrCreateTimer(int32_t uid,
@@ -341,31 +242,13 @@ std::shared_ptr<StatsHelper::ActiveTimer> BluetoothEntity::GetOrCreateTimer(int3
     std::shared_ptr<StatsHelper::ActiveTimer> timer = nullptr;
     switch (statsType) {
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN: {
-            auto brScanIter = appBluetoothBrScanTimerMap_.find(uid);
-            if (brScanIter != appBluetoothBrScanTimerMap_.end()) {
-                STATS_HILOGD(COMP_SVC, "Get blueooth Br scan timer for uid: %{public}d", uid);
-                timer = brScanIter->second;
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "Create bluetooth Br scan timer for uid: %{public}d", uid);
-            std::shared_ptr<StatsHelper::ActiveTimer> brScanTimer = std::make_shared<StatsHelper::ActiveTimer>();
-            appBluetoothBrScanTimerMap_.insert(
-                std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, brScanTimer));
-            timer = brScanTimer;
+            STATS_HILOGD(COMP_SVC, "Get blueooth Br scan timer for uid: %{public}d", uid);
+            timer = GetTimerStore().GetTimer(StatsTimerStore::TIMER_KIND_BLUETOOTH_BR_SCAN, uid);
             break;
         }
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN: {
-            auto bleScanIter = appBluetoothBleScanTimerMap_.find(uid);
-            if (bleScanIter != appBluetoothBleScanTimerMap_.end()) {
-                STATS_HILOGD(COMP_SVC, "Get blueooth Ble scan timer for uid: %{public}d", uid);
-                timer = bleScanIter->second;
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "Create bluetooth Ble scan timer for uid: %{public}d", uid);
-            std::shared_ptr<StatsHelper::ActiveTimer> bleScanTimer = std::make_shared<StatsHelper::ActiveTimer>();
-            appBluetoothBleScanTimerMap_.insert(
-                std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, bleScanTimer));
-            timer = bleScanTimer;
+            STATS_HILOGD(COMP_SVC, "Get blueooth Ble scan timer for uid: %{public}d", uid);
+            timer = GetTimerStore().GetTimer(StatsTimerStore::TIMER_KIND_BLUETOOTH_BLE_SCAN, uid);
             break;
         }
         default:
@@ -387,7 +270,7 @@ std::shared_ptr<StatsHelper::ActiveTimer> BluetoothEntity::GetOrCreateTimer(Stat
                 break;
             }
             STATS_HILOGD(COMP_SVC, "Create blueooth Br on timer");
-            bluetoothBrOnTimer_ = std::make_shared<StatsHelper::ActiveTimer>();
+            bluetoothBrOnTimer_ = AllocateTimer();
             timer = bluetoothBrOnTimer_;
             break;
         }
@@ -398,7 +281,7 @@ std::shared_ptr<StatsHelper::ActiveTimer> BluetoothEntity::GetOrCreateTimer(Stat
                 break;
             }
             STATS_HILOGD(COMP_SVC, "Create blueooth Ble on timer");
-            bluetoothBleOnTimer_ = std::make_shared<StatsHelper::ActiveTimer>();
+            bluetoothBleOnTimer_ = AllocateTimer();
             timer = bluetoothBleOnTimer_;
             break;
         }
@@ -15,6 +15,8 @@
 
 #include "entities/camera_entity.h"
 
+#include <cinttypes>
+
 #include "battery_stats_service.h"
 #include "stats_log.h"
 
@@ -32,15 +34,8 @@ int64_t CameraEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsTy
 {
     int64_t activeTimeMs = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_CAMERA_ON) {
-        for (auto& cameraIter : cameraTimerMap_) {
-            auto uidIter = cameraIter.second.find(uid);
-            if (uidIter != cameraIter.second.end()) {
-                activeTimeMs += uidIter->second->GetRunningTimeMs();
-            } else {
-                STATS_HILOGD(COMP_SVC, "Didn't find related timer for uid: %{public}d in camera id: %{private}s",
-                    uid, cameraIter.first.c_str());
-            }
-        }
+        activeTimeMs = GetTimerStore().GetRunningTimeMs(StatsTimerStore::TIMER_KIND_CAMERA_ON, uid);
+        STATS_HILOGD(COMP_SVC, "Get camera on time: %{public}" PRId64 "ms for uid: %{public}d", activeTimeMs, uid);
     }
     return activeTimeMs;
 }
@@ -51,30 +46,16 @@ void CameraEntity::Calculate(int32_t uid)
     auto cameraOnAverageMa = bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_CAMERA_ON);
     auto cameraOnTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_CAMERA_ON);
     auto cameraOnPowerMah = cameraOnAverageMa * cameraOnTimeMs / StatsUtils::MS_IN_HOUR;
-    auto iter = cameraPowerMap_.find(uid);
-    if (iter != cameraPowerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Update camera on power consumption: %{public}lfmAh for uid: %{public}d",
-            cameraOnAverageMa, uid);
-        iter->second = cameraOnPowerMah;
-    } else {
-        STATS_HILOGD(COMP_SVC, "Create camera on power consumption: %{public}lfmAh for uid: %{public}d",
-            cameraOnAverageMa, uid);
-        cameraPowerMap_.insert(std::pair<int32_t, double>(uid, cameraOnPowerMah));
-    }
+    STATS_HILOGD(COMP_SVC, "Update camera on power consumption: %{public}lfmAh for uid: %{public}d",
+        cameraOnPowerMah, uid);
+    GetTimerStore().SetPowerMah(StatsTimerStore::TIMER_KIND_CAMERA_ON, uid, cameraOnPowerMah);
 }
 
 double CameraEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
-    double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = cameraPowerMap_.find(uidOrUserId);
-    if (iter != cameraPowerMap_.end()) {
-        power = iter->second;
-        STATS_HILOGD(COMP_SVC, "Get app camera power consumption: %{public}lfmAh for uid: %{public}d",
-            power, uidOrUserId);
-    } else {
-        STATS_HILOGD(COMP_SVC,
-            "No app camera power consumption related to uid: %{public}d was found, return 0", uidOrUserId);
-    }
+    double power = GetTimerStore().GetPowerMah(StatsTimerStore::TIMER_KIND_CAMERA_ON, uidOrUserId);
+    STATS_HILOGD(COMP_SVC, "Get app camera power consumption: %{public}lfmAh for uid: %{public}d",
+        power, uidOrUserId);
     return power;
 }
 
@@ -82,15 +63,9 @@ double CameraEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t u
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_CAMERA_ON) {
-        auto cameraOnIter = cameraPowerMap_.find(uid);
-        if (cameraOnIter != cameraPowerMap_.end()) {
-            power = cameraOnIter->second;
-            STATS_HILOGD(COMP_SVC, "Get camera on power consumption: %{public}lfmAh for uid: %{public}d",
-                power, uid);
-        } else {
-            STATS_HILOGD(COMP_SVC,
-                "No camera on power consumption related to uid: %{public}d was found, return 0", uid);
-        }
+        power = GetTimerStore().GetPowerMah(StatsTimerStore::TIMER_KIND_CAMERA_ON, uid);
+        STATS_HILOGD(COMP_SVC, "Get camera on power consumption: %{public}lfmAh for uid: %{public}d",
+            power, uid);
     }
     return power;
 }
@@ -98,44 +73,18 @@ double CameraEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t u
 std::shared_ptr<StatsHelper::ActiveTimer> CameraEntity::GetOrCreateTimer(const std::string& deviceId, int32_t uid,
     StatsUtils::StatsType statsType, int16_t level)
 {
-    std::shared_ptr<StatsHelper::ActiveTimer> cmrTimer = nullptr;
     if (statsType != StatsUtils::STATS_TYPE_CAMERA_ON) {
-        return cmrTimer;
+        return nullptr;
     }
-
-    auto cameraIter = cameraTimerMap_.find(deviceId);
-    if (cameraIter != cameraTimerMap_.end()) {
-        auto uidIter = cameraIter->second.find(uid);
-        if (uidIter != cameraIter->second.end()) {
-            return uidIter->second;
-        }
-        cmrTimer = std::make_shared<StatsHelper::ActiveTimer>();
-        cameraIter->second.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, cmrTimer));
-        return cmrTimer;
-    }
-    cmrTimer = std::make_shared<StatsHelper::ActiveTimer>();
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> uidTimerMap;
-    uidTimerMap.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, cmrTimer));
-    cameraTimerMap_.insert(
-        std::pair<std::string, std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>>(deviceId, uidTimerMap));
-    return cmrTimer;
+    // BatteryStatsCore tracks the sessions per device, a uid is on camera while any of its sessions is open
+    STATS_HILOGD(COMP_SVC, "Get camera on timer for uid: %{public}d, camera id: %{private}s", uid, deviceId.c_str());
+    return GetTimerStore().GetTimer(StatsTimerStore::TIMER_KIND_CAMERA_ON, uid);
 }
 
 void CameraEntity::Reset()
 {
-    // Reset app Camera on total power consumption
-    for (auto& iter : cameraPowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
-
-    // Reset Camera on timer
-    for (auto& cameraIter : cameraTimerMap_) {
-        for (auto& uidIter : cameraIter.second) {
-            if (uidIter.second) {
-                uidIter.second->Reset();
-            }
-        }
-    }
+    // Reset app Camera on timer and power consumption
+    GetTimerStore().Reset(StatsTimerStore::TIMER_KIND_CAMERA_ON);
 }
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file
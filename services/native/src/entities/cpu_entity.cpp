@@ -15,14 +15,14 @@
 
 #include "entities/cpu_entity.h"
 
+#include <algorithm>
+
 #include "battery_stats_service.h"
 #include "stats_log.h"
+#include "stats_uid_interner.h"
 
 namespace OHOS {
 namespace PowerMgr {
-namespace {
-}
-
 CpuEntity::CpuEntity()
 {
     STATS_HILOGD(COMP_SVC, "Created cpu entity");
@@ -33,14 +33,33 @@ CpuEntity::CpuEntity()
     }
 }
 
+CpuEntity::UidCpuStats* CpuEntity::GetOrCreateUidStats(int32_t uid)
+{
+    uint32_t index = StatsUidInterner::GetInstance().Intern(uid);
+    if (index >= uidCpuStats_.size()) {
+        uidCpuStats_.resize(index + 1);
+    }
+    return &uidCpuStats_[index];
+}
+
+const CpuEntity::UidCpuStats* CpuEntity::FindUidStats(int32_t uid) const
+{
+    uint32_t index = 0;
+    if (!StatsUidInterner::GetInstance().Find(uid, index) || index >= uidCpuStats_.size()) {
+        return nullptr;
+    }
+    return &uidCpuStats_[index];
+}
+
 int64_t CpuEntity::GetCpuTimeMs(int32_t uid)
 {
+    std::lock_guard<std::mutex> lock(cpuEntityMutex_);
     int64_t cpuTimeMs = StatsUtils::DEFAULT_VALUE;
-    auto iter = cpuTimeMap_.find(uid);
-    if (iter != cpuTimeMap_.end()) {
+    auto stats = FindUidStats(uid);
+    if (stats != nullptr) {
+        cpuTimeMs = stats->cpuTimeMs;
         STATS_HILOGD(COMP_SVC, "Get cpu time: %{public}sms for uid: %{public}d",
             std::to_string(cpuTimeMs).c_str(), uid);
-        cpuTimeMs = iter->second;
     } else {
         STATS_HILOGD(COMP_SVC, "No cpu time realted to uid: %{public}d was found, return 0", uid);
     }
@@ -49,6 +68,7 @@ int64_t CpuEntity::GetCpuTimeMs(int32_t uid)
 
 void CpuEntity::UpdateCpuTime()
 {
+    std::lock_guard<std::mutex> lock(cpuEntityMutex_);
     if (cpuReader_) {
         if (!cpuReader_->UpdateCpuTime()) {
             STATS_HILOGE(COMP_SVC, "Update CPU time failed");
@@ -58,7 +78,95 @@ void CpuEntity::UpdateCpuTime()
     }
 }
 
+void CpuEntity::SetParallelRead(bool parallelRead)
+{
+    std::lock_guard<std::mutex> lock(cpuEntityMutex_);
+    if (cpuReader_) {
+        cpuReader_->SetParallelRead(parallelRead);
+        STATS_HILOGI(COMP_SVC, "Set cpu parallel read: %{public}d", parallelRead);
+    }
+}
+
+void CpuEntity::SetProcRoot(const std::string& procRoot)
+{
+    std::lock_guard<std::mutex> lock(cpuEntityMutex_);
+    if (cpuReader_) {
+        cpuReader_->SetProcRoot(procRoot);
+    }
+}
+
 void CpuEntity::Calculate(int32_t uid)
+{
+    std::lock_guard<std::mutex> lock(cpuEntityMutex_);
+    if (uid == StatsUtils::INVALID_VALUE) {
+        CalculateAll();
+        return;
+    }
+    CalculateUid(*GetOrCreateUidStats(uid), uid, CalculateCpuSpeedPower(uid), IsWeightedCpuTime());
+}
+
+bool CpuEntity::IsWeightedCpuTime()
+{
+    // Shared accounting splits the cpu time among the cpus running at the same time, like the shared hardware
+    return GetTimerStore().GetAccountingMode() == StatsTimerStore::ACCOUNTING_SHARED;
+}
+
+void CpuEntity::CalculateAll()
+{
+    // All the powers come from the uid-indexed columns of the reader, no per-uid lookups or copies
+    auto parser = BatteryStatsService::GetInstance()->GetBatteryStatsParser();
+    const auto& speedCoefficients = parser->GetCpuSpeedCoefficientsMa();
+    const auto& clusterCoefficients = parser->GetCpuClusterCoefficientsMa();
+    double activeCoefficient = parser->GetCpuActiveCoefficientMa();
+    bool isWeighted = IsWeightedCpuTime();
+    size_t rowCount = 0;
+    size_t rowSize = 0;
+    const int64_t* freqTimes = cpuReader_->GetFreqTimeMatrix(rowCount, rowSize);
+    size_t speedCount = std::min(rowSize, speedCoefficients.size());
+    speedPowers_.resize(rowCount);
+    for (size_t row = 0; row < rowCount; row++) {
+        speedPowers_[row] = StatsUtils::DotProduct(freqTimes + row * rowSize, speedCoefficients.data(), speedCount) /
+            StatsUtils::MS_IN_HOUR;
+    }
+    size_t activeCount = 0;
+    const int64_t* activeTimes = cpuReader_->GetActiveTimeColumn(activeCount, isWeighted);
+    size_t clusterCount = 0;
+    const std::vector<int64_t>* clusterTimes = cpuReader_->GetClusterTimeColumn(clusterCount);
+    size_t uidTimeCount = 0;
+    const std::vector<int64_t>* uidTimes = cpuReader_->GetUidTimeColumn(uidTimeCount);
+
+    uint32_t uidCount = StatsUidInterner::GetInstance().GetCount();
+    if (uidCpuStats_.size() < uidCount) {
+        uidCpuStats_.resize(uidCount);
+    }
+    for (uint32_t index = 0; index < uidCount; index++) {
+        auto& stats = uidCpuStats_[index];
+        int64_t cpuTimeMs = StatsUtils::DEFAULT_VALUE;
+        if (index < uidTimeCount) {
+            for (int64_t time : uidTimes[index]) {
+                cpuTimeMs += time;
+            }
+        }
+        stats.cpuTimeMs = cpuTimeMs;
+        stats.activePowerMah = index < activeCount ?
+            activeCoefficient * activeTimes[index] / StatsUtils::MS_IN_HOUR : StatsUtils::DEFAULT_VALUE;
+        stats.clusterPowerMah = StatsUtils::DEFAULT_VALUE;
+        if (index < clusterCount) {
+            // The weighted times take the second half of the row
+            size_t halfSize = clusterTimes[index].size() / 2;
+            const int64_t* clusterRow = clusterTimes[index].data() + (isWeighted ? halfSize : 0);
+            size_t clusterNum = std::min(halfSize, clusterCoefficients.size());
+            for (size_t i = 0; i < clusterNum; i++) {
+                stats.clusterPowerMah += clusterCoefficients[i] * clusterRow[i] / StatsUtils::MS_IN_HOUR;
+            }
+        }
+        stats.speedPowerMah = index < rowCount ? speedPowers_[index] : StatsUtils::DEFAULT_VALUE;
+        stats.totalPowerMah = stats.activePowerMah + stats.clusterPowerMah + stats.speedPowerMah;
+    }
+    STATS_HILOGD(COMP_SVC, "Update cpu power consumption of %{public}u uids", uidCount);
+}
+
+void CpuEntity::CalculateUid(UidCpuStats& stats, int32_t uid, double cpuSpeedPower, bool isWeighted)
 {
     double cpuTotalPowerMah = StatsUtils::DEFAULT_VALUE;
     // Get cpu time related with uid
@@ -67,114 +175,83 @@ void CpuEntity::Calculate(int32_t uid)
     for (uint32_t i = 0; i < cpuTimeVec.size(); i++) {
         cpuTimeMs += cpuTimeVec[i];
     }
-    auto cpuTimeIter = cpuTimeMap_.find(uid);
-    if (cpuTimeIter != cpuTimeMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Update cpu time: %{public}sms for uid: %{public}d",
-            std::to_string(cpuTimeMs).c_str(), uid);
-        cpuTimeIter->second = cpuTimeMs;
-    } else {
-        STATS_HILOGD(COMP_SVC, "Create cpu time: %{public}sms for uid: %{public}d",
-            std::to_string(cpuTimeMs).c_str(), uid);
-        cpuTimeMap_.insert(std::pair<int32_t, int64_t>(uid, cpuTimeMs));
-    }
+    STATS_HILOGD(COMP_SVC, "Update cpu time: %{public}sms for uid: %{public}d",
+        std::to_string(cpuTimeMs).c_str(), uid);
+    stats.cpuTimeMs = cpuTimeMs;
 
     // Calculate cpu active power
-    cpuTotalPowerMah += CalculateCpuActivePower(uid);
+    stats.activePowerMah = CalculateCpuActivePower(uid, isWeighted);
+    cpuTotalPowerMah += stats.activePowerMah;
 
     // Calculate cpu cluster power
-    cpuTotalPowerMah += CalculateCpuClusterPower(uid);
+    stats.clusterPowerMah = CalculateCpuClusterPower(uid, isWeighted);
+    cpuTotalPowerMah += stats.clusterPowerMah;
 
     // Calculate cpu speed power
-    cpuTotalPowerMah += CalculateCpuSpeedPower(uid);
+    stats.speedPowerMah = cpuSpeedPower;
+    cpuTotalPowerMah += cpuSpeedPower;
 
-    auto cpuTotalIter = cpuTotalPowerMap_.find(uid);
-    if (cpuTotalIter != cpuTotalPowerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Update cpu speed power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuTotalPowerMah, uid);
-        cpuTotalIter->second = cpuTotalPowerMah;
-    } else {
-        STATS_HILOGD(COMP_SVC, "Create cpu speed power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuTotalPowerMah, uid);
-        cpuTotalPowerMap_.insert(std::pair<int32_t, double>(uid, cpuTotalPowerMah));
-    }
+    STATS_HILOGD(COMP_SVC, "Update cpu total power consumption: %{public}lfmAh for uid: %{public}d",
+        cpuTotalPowerMah, uid);
+    stats.totalPowerMah = cpuTotalPowerMah;
 }
 
-double CpuEntity::CalculateCpuActivePower(int32_t uid)
+double CpuEntity::CalculateCpuActivePower(int32_t uid, bool isWeighted)
 {
     auto bss = BatteryStatsService::GetInstance();
-    double cpuActiveAverageMa =
-        bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_CPU_ACTIVE);
-    int64_t cpuActiveTimeMs = cpuReader_->GetUidCpuActiveTimeMs(uid);
+    double cpuActiveAverageMa = bss->GetBatteryStatsParser()->GetCpuActiveCoefficientMa();
+    int64_t cpuActiveTimeMs = isWeighted ? cpuReader_->GetUidCpuWeightedActiveTimeMs(uid) :
+        cpuReader_->GetUidCpuActiveTimeMs(uid);
     double cpuActivePower = cpuActiveAverageMa * cpuActiveTimeMs / StatsUtils::MS_IN_HOUR;
 
-    auto cpuActiveIter = cpuActivePowerMap_.find(uid);
-    if (cpuActiveIter != cpuActivePowerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Update cpu active power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuActivePower, uid);
-        cpuActiveIter->second = cpuActivePower;
-    } else {
-        STATS_HILOGD(COMP_SVC, "Create cpu active power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuActivePower, uid);
-        cpuActivePowerMap_.insert(std::pair<int32_t, double>(uid, cpuActivePower));
-    }
+    STATS_HILOGD(COMP_SVC, "Update cpu active power consumption: %{public}lfmAh for uid: %{public}d",
+        cpuActivePower, uid);
     return cpuActivePower;
 }
 
-double CpuEntity::CalculateCpuClusterPower(int32_t uid)
+double CpuEntity::CalculateCpuClusterPower(int32_t uid, bool isWeighted)
 {
     double cpuClusterPower = StatsUtils::DEFAULT_VALUE;
     auto bss = BatteryStatsService::GetInstance();
-    for (uint16_t i = 0; i < bss->GetBatteryStatsParser()->GetClusterNum(); i++) {
-        double cpuClusterAverageMa =
-            bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_CPU_CLUSTER, i);
-        int64_t cpuClusterTimeMs = cpuReader_->GetUidCpuClusterTimeMs(uid, i);
-        cpuClusterPower += cpuClusterAverageMa * cpuClusterTimeMs / StatsUtils::MS_IN_HOUR;
-    }
-    auto cpuClusterIter = cpuClusterPowerMap_.find(uid);
-    if (cpuClusterIter != cpuClusterPowerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Update cpu cluster power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuClusterPower, uid);
-        cpuClusterIter->second = cpuClusterPower;
-    } else {
-        STATS_HILOGD(COMP_SVC, "Create cpu cluster power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuClusterPower, uid);
-        cpuClusterPowerMap_.insert(std::pair<int32_t, double>(uid, cpuClusterPower));
+    const auto& clusterCoefficients = bss->GetBatteryStatsParser()->GetCpuClusterCoefficientsMa();
+    for (uint32_t i = 0; i < clusterCoefficients.size(); i++) {
+        int64_t cpuClusterTimeMs = isWeighted ? cpuReader_->GetUidCpuWeightedClusterTimeMs(uid, i) :
+            cpuReader_->GetUidCpuClusterTimeMs(uid, i);
+        cpuClusterPower += clusterCoefficients[i] * cpuClusterTimeMs / StatsUtils::MS_IN_HOUR;
     }
+    STATS_HILOGD(COMP_SVC, "Update cpu cluster power consumption: %{public}lfmAh for uid: %{public}d",
+        cpuClusterPower, uid);
     return cpuClusterPower;
 }
 
 double CpuEntity::CalculateCpuSpeedPower(int32_t uid)
 {
     double cpuSpeedPower = StatsUtils::DEFAULT_VALUE;
-    auto bss = BatteryStatsService::GetInstance();
-    for (uint16_t i = 0; i < bss->GetBatteryStatsParser()->GetClusterNum(); i++) {
-        for (uint16_t j = 0; j < bss->GetBatteryStatsParser()->GetSpeedNum(i); j++) {
-            STATS_HILOGD(COMP_SVC, "Calculate cluster: %{public}d, speed: %{public}d", j, i);
-            std::string statType = StatsUtils::CURRENT_CPU_SPEED + std::to_string(i);
-            double cpuSpeedAverageMa = bss->GetBatteryStatsParser()->GetAveragePowerMa(statType, j);
-            int64_t cpuSpeedTimeMs = cpuReader_->GetUidCpuFreqTimeMs(uid, i, j);
-            cpuSpeedPower += cpuSpeedAverageMa * cpuSpeedTimeMs / StatsUtils::MS_IN_HOUR;
+    auto parser = BatteryStatsService::GetInstance()->GetBatteryStatsParser();
+    const auto& speedCoefficients = parser->GetCpuSpeedCoefficientsMa();
+    size_t offset = 0;
+    for (uint16_t i = 0; i < parser->GetClusterNum(); i++) {
+        size_t speedNum = 0;
+        const int64_t* speedTimesMs = cpuReader_->GetUidCpuFreqTimesMs(uid, i, speedNum);
+        if (speedTimesMs == nullptr || offset + speedNum > speedCoefficients.size()) {
+            break;
         }
+        cpuSpeedPower += StatsUtils::DotProduct(speedTimesMs, speedCoefficients.data() + offset, speedNum) /
+            StatsUtils::MS_IN_HOUR;
+        offset += speedNum;
     }
-    auto cpuSpeedIter = cpuSpeedPowerMap_.find(uid);
-    if (cpuSpeedIter != cpuSpeedPowerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Update cpu speed power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuSpeedPower, uid);
-        cpuSpeedIter->second = cpuSpeedPower;
-    } else {
-        STATS_HILOGD(COMP_SVC, "Create cpu speed power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuSpeedPower, uid);
-        cpuSpeedPowerMap_.insert(std::pair<int32_t, double>(uid, cpuSpeedPower));
-    }
+    STATS_HILOGD(COMP_SVC, "Update cpu speed power consumption: %{public}lfmAh for uid: %{public}d",
+        cpuSpeedPower, uid);
     return cpuSpeedPower;
 }
 
 double CpuEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
+    std::lock_guard<std::mutex> lock(cpuEntityMutex_);
     double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = cpuTotalPowerMap_.find(uidOrUserId);
-    if (iter != cpuTotalPowerMap_.end()) {
-        power = iter->second;
+    auto stats = FindUidStats(uidOrUserId);
+    if (stats != nullptr) {
+        power = stats->totalPowerMah;
         STATS_HILOGD(COMP_SVC, "Get app cpu total power consumption: %{public}lfmAh for uid: %{public}d",
             power, uidOrUserId);
     } else {
@@ -186,73 +263,46 @@ double CpuEntity::GetEntityPowerMah(int32_t uidOrUserId)
 
 double CpuEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid)
 {
+    std::lock_guard<std::mutex> lock(cpuEntityMutex_);
     double power = StatsUtils::DEFAULT_VALUE;
+    auto stats = FindUidStats(uid);
+    if (stats == nullptr) {
+        STATS_HILOGD(COMP_SVC, "No cpu power consumption related to uid: %{public}d was found, return 0", uid);
+        return power;
+    }
 
     if (statsType == StatsUtils::STATS_TYPE_CPU_ACTIVE) {
-        auto cpuActiveIter = cpuActivePowerMap_.find(uid);
-        if (cpuActiveIter != cpuActivePowerMap_.end()) {
-            power = cpuActiveIter->second;
-            STATS_HILOGD(COMP_SVC, "Get cpu active power consumption: %{public}lfmAh for uid: %{public}d",
-                power, uid);
-        } else {
-            STATS_HILOGD(COMP_SVC,
-                "No cpu active power consumption related to uid: %{public}d was found, return 0", uid);
-        }
+        power = stats->activePowerMah;
+        STATS_HILOGD(COMP_SVC, "Get cpu active power consumption: %{public}lfmAh for uid: %{public}d",
+            power, uid);
     } else if (statsType == StatsUtils::STATS_TYPE_CPU_CLUSTER) {
-        auto cpuClusterIter = cpuClusterPowerMap_.find(uid);
-        if (cpuClusterIter != cpuClusterPowerMap_.end()) {
-            power = cpuClusterIter->second;
-            STATS_HILOGD(COMP_SVC, "Get cpu cluster power consumption: %{public}lfmAh for uid: %{public}d",
-                power, uid);
-        } else {
-            STATS_HILOGD(COMP_SVC,
-                "No cpu cluster power consumption related to uid: %{public}d was found, return 0", uid);
-        }
+        power = stats->clusterPowerMah;
+        STATS_HILOGD(COMP_SVC, "Get cpu cluster power consumption: %{public}lfmAh for uid: %{public}d",
+            power, uid);
     } else if (statsType == StatsUtils::STATS_TYPE_CPU_SPEED) {
-        auto cpuSpeedIter = cpuSpeedPowerMap_.find(uid);
-        if (cpuSpeedIter != cpuSpeedPowerMap_.end()) {
-            power = cpuSpeedIter->second;
-            STATS_HILOGD(COMP_SVC, "Get cpu speed power consumption: %{public}lfmAh for uid: %{public}d",
-                power, uid);
-        } else {
-            STATS_HILOGD(COMP_SVC,
-                "No cpu speed power consumption related to uid: %{public}d was found, return 0", uid);
-        }
+        power = stats->speedPowerMah;
+        STATS_HILOGD(COMP_SVC, "Get cpu speed power consumption: %{public}lfmAh for uid: %{public}d",
+            power, uid);
     }
     return power;
 }
 
 void CpuEntity::Reset()
 {
-    // Reset app Cpu time
-    for (auto& iter : cpuTimeMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
-
-    // Reset app Cpu total power consumption
-    for (auto& iter : cpuTotalPowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
-
-    // Reset app Cpu active power consumption
-    for (auto& iter : cpuActivePowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
-
-    // Reset app Cpu cluster power consumption
-    for (auto& iter : cpuClusterPowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
-
-    // Reset app Cpu speed power consumption
-    for (auto& iter : cpuSpeedPowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
+    // Reset app Cpu time and power consumption
+    std::lock_guard<std::mutex> lock(cpuEntityMutex_);
+    std::fill(uidCpuStats_.begin(), uidCpuStats_.end(), UidCpuStats());
 }
 
 void CpuEntity::DumpInfo(std::string& result, int32_t uid)
 {
-    if (cpuReader_) {
+    std::lock_guard<std::mutex> lock(cpuEntityMutex_);
+    if (!cpuReader_) {
+        return;
+    }
+    if (uid == StatsUtils::INVALID_VALUE) {
+        cpuReader_->DumpReadInfo(result);
+    } else {
         cpuReader_->DumpInfo(result, uid);
     }
 }
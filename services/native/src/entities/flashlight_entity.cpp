@@ -37,13 +37,8 @@ int64_t FlashlightEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType sta
         return activeTimeMs;
     }
 
-    auto iter = flashlightTimerMap_.find(uid);
-    if (iter != flashlightTimerMap_.end()) {
-        activeTimeMs = iter->second->GetRunningTimeMs();
-        STATS_HILOGD(COMP_SVC, "Get flashlight on time: %{public}" PRId64 "ms for uid: %{public}d", activeTimeMs, uid);
-        return activeTimeMs;
-    }
-    STATS_HILOGD(COMP_SVC, "Didn't find related timer for uid: %{public}d, return 0", uid);
+    activeTimeMs = GetTimerStore().GetRunningTimeMs(StatsTimerStore::TIMER_KIND_FLASHLIGHT_ON, uid);
+    STATS_HILOGD(COMP_SVC, "Get flashlight on time: %{public}" PRId64 "ms for uid: %{public}d", activeTimeMs, uid);
     return activeTimeMs;
 }
 
@@ -54,30 +49,16 @@ void FlashlightEntity::Calculate(int32_t uid)
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_FLASHLIGHT_ON);
     auto flashlightOnTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_FLASHLIGHT_ON);
     auto flashlightOnPowerMah = flashlightOnAverageMa * flashlightOnTimeMs / StatsUtils::MS_IN_HOUR;
-    auto iter = flashlightPowerMap_.find(uid);
-    if (iter != flashlightPowerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Update flashlight on power consumption: %{public}lfmAh for uid: %{public}d",
-            flashlightOnAverageMa, uid);
-        iter->second = flashlightOnPowerMah;
-    } else {
-        STATS_HILOGD(COMP_SVC, "Create flashlight on power consumption: %{public}lfmAh for uid: %{public}d",
-            flashlightOnAverageMa, uid);
-        flashlightPowerMap_.insert(std::pair<int32_t, double>(uid, flashlightOnPowerMah));
-    }
+    STATS_HILOGD(COMP_SVC, "Update flashlight on power consumption: %{public}lfmAh for uid: %{public}d",
+        flashlightOnPowerMah, uid);
+    GetTimerStore().SetPowerMah(StatsTimerStore::TIMER_KIND_FLASHLIGHT_ON, uid, flashlightOnPowerMah);
 }
 
 double FlashlightEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
-    double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = flashlightPowerMap_.find(uidOrUserId);
-    if (iter != flashlightPowerMap_.end()) {
-        power = iter->second;
-        STATS_HILOGD(COMP_SVC, "Get app flashlight power consumption: %{public}lfmAh for uid: %{public}d",
-            power, uidOrUserId);
-    } else {
-        STATS_HILOGD(COMP_SVC,
-            "No app flashlight power consumption related to uid: %{public}d was found, return 0", uidOrUserId);
-    }
+    double power = GetTimerStore().GetPowerMah(StatsTimerStore::TIMER_KIND_FLASHLIGHT_ON, uidOrUserId);
+    STATS_HILOGD(COMP_SVC, "Get app flashlight power consumption: %{public}lfmAh for uid: %{public}d",
+        power, uidOrUserId);
     return power;
 }
 
@@ -85,15 +66,9 @@ double FlashlightEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_FLASHLIGHT_ON) {
-        auto flashlightOnIter = flashlightPowerMap_.find(uid);
-        if (flashlightOnIter != flashlightPowerMap_.end()) {
-            power = flashlightOnIter->second;
-            STATS_HILOGD(COMP_SVC,
-                "Get flashlight on power consumption: %{public}lfmAh for uid: %{public}d", power, uid);
-        } else {
-            STATS_HILOGD(COMP_SVC,
-                "No flashlight on power consumption related to uid: %{public}d was found, return 0", uid);
-        }
+        power = GetTimerStore().GetPowerMah(StatsTimerStore::TIMER_KIND_FLASHLIGHT_ON, uid);
+        STATS_HILOGD(COMP_SVC, "Get flashlight on power consumption: %{public}lfmAh for uid: %{public}d",
+            power, uid);
     }
     return power;
 }
@@ -104,31 +79,14 @@ std::shared_ptr<StatsHelper::ActiveTimer> FlashlightEntity::GetOrCreateTimer(int
     if (statsType != StatsUtils::STATS_TYPE_FLASHLIGHT_ON) {
         return nullptr;
     }
-
-    auto flashlightOnIter = flashlightTimerMap_.find(uid);
-    if (flashlightOnIter != flashlightTimerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Get flashlight on timer for uid: %{public}d", uid);
-        return flashlightOnIter->second;
-    }
-    STATS_HILOGD(COMP_SVC, "Create flashlight on timer for uid: %{public}d", uid);
-    std::shared_ptr<StatsHelper::ActiveTimer> flashTimer = std::make_shared<StatsHelper::ActiveTimer>();
-    flashlightTimerMap_.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, flashTimer));
-    return flashTimer;
+    STATS_HILOGD(COMP_SVC, "Get flashlight on timer for uid: %{public}d", uid);
+    return GetTimerStore().GetTimer(StatsTimerStore::TIMER_KIND_FLASHLIGHT_ON, uid);
 }
 
 void FlashlightEntity::Reset()
 {
-    // Reset app Flashlight on total power consumption
-    for (auto& iter : flashlightPowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
-
-    // Reset Flashlight on timer
-    for (auto& iter : flashlightTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
+    // Reset app Flashlight on timer and power consumption
+    GetTimerStore().Reset(StatsTimerStore::TIMER_KIND_FLASHLIGHT_ON);
 }
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file
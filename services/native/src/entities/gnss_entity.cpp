@@ -37,13 +37,8 @@ int64_t GnssEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsType
         return activeTimeMs;
     }
 
-    auto iter = gnssTimerMap_.find(uid);
-    if (iter != gnssTimerMap_.end()) {
-        activeTimeMs = iter->second->GetRunningTimeMs();
-        STATS_HILOGD(COMP_SVC, "Get gnss on time: %{public}" PRId64 "ms for uid: %{public}d", activeTimeMs, uid);
-        return activeTimeMs;
-    }
-    STATS_HILOGD(COMP_SVC, "Didn't find related timer for uid: %{public}d, return 0", uid);
+    activeTimeMs = GetTimerStore().GetRunningTimeMs(StatsTimerStore::TIMER_KIND_GNSS_ON, uid);
+    STATS_HILOGD(COMP_SVC, "Get gnss on time: %{public}" PRId64 "ms for uid: %{public}d", activeTimeMs, uid);
     return activeTimeMs;
 }
 
@@ -53,30 +48,16 @@ void GnssEntity::Calculate(int32_t uid)
     auto gnssOnAverageMa = bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_GNSS_ON);
     auto gnssOnTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_GNSS_ON);
     auto gnssOnPowerMah = gnssOnAverageMa * gnssOnTimeMs / StatsUtils::MS_IN_HOUR;
-    auto iter = gnssPowerMap_.find(uid);
-    if (iter != gnssPowerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Update gnss on power consumption: %{public}lfmAh for uid: %{public}d",
-            gnssOnAverageMa, uid);
-        iter->second = gnssOnPowerMah;
-    } else {
-        STATS_HILOGD(COMP_SVC, "Create gnss on power consumption: %{public}lfmAh for uid: %{public}d",
-            gnssOnAverageMa, uid);
-        gnssPowerMap_.insert(std::pair<int32_t, double>(uid, gnssOnPowerMah));
-    }
+    STATS_HILOGD(COMP_SVC, "Update gnss on power consumption: %{public}lfmAh for uid: %{public}d",
+        gnssOnPowerMah, uid);
+    GetTimerStore().SetPowerMah(StatsTimerStore::TIMER_KIND_GNSS_ON, uid, gnssOnPowerMah);
 }
 
 double GnssEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
-    double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = gnssPowerMap_.find(uidOrUserId);
-    if (iter != gnssPowerMap_.end()) {
-        power = iter->second;
-        STATS_HILOGD(COMP_SVC, "Get app gnss power consumption: %{public}lfmAh for uid: %{public}d",
-            power, uidOrUserId);
-    } else {
-        STATS_HILOGD(COMP_SVC,
-            "No app gnss power consumption related to uid: %{public}d was found, return 0", uidOrUserId);
-    }
+    double power = GetTimerStore().GetPowerMah(StatsTimerStore::TIMER_KIND_GNSS_ON, uidOrUserId);
+    STATS_HILOGD(COMP_SVC, "Get app gnss power consumption: %{public}lfmAh for uid: %{public}d",
+        power, uidOrUserId);
     return power;
 }
 
@@ -84,15 +65,9 @@ double GnssEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_GNSS_ON) {
-        auto gnssOnIter = gnssPowerMap_.find(uid);
-        if (gnssOnIter != gnssPowerMap_.end()) {
-            power = gnssOnIter->second;
-            STATS_HILOGD(COMP_SVC, "Get gnss on power consumption: %{public}lfmAh for uid: %{public}d",
-                power, uid);
-        } else {
-            STATS_HILOGD(COMP_SVC,
-                "No gnss on power consumption related to uid: %{public}d was found, return 0", uid);
-        }
+        power = GetTimerStore().GetPowerMah(StatsTimerStore::TIMER_KIND_GNSS_ON, uid);
+        STATS_HILOGD(COMP_SVC, "Get gnss on power consumption: %{public}lfmAh for uid: %{public}d",
+            power, uid);
     }
     return power;
 }
@@ -103,31 +78,14 @@ std::shared_ptr<StatsHelper::ActiveTimer> GnssEntity::GetOrCreateTimer(int32_t u
     if (statsType != StatsUtils::STATS_TYPE_GNSS_ON) {
         return nullptr;
     }
-
-    auto gnssOnIter = gnssTimerMap_.find(uid);
-    if (gnssOnIter != gnssTimerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Get gnss on timer for uid: %{public}d", uid);
-        return gnssOnIter->second;
-    }
-    STATS_HILOGD(COMP_SVC, "Create gnss on timer for uid: %{public}d", uid);
-    std::shared_ptr<StatsHelper::ActiveTimer> gnssTimer = std::make_shared<StatsHelper::ActiveTimer>();
-    gnssTimerMap_.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, gnssTimer));
-    return gnssTimer;
+    STATS_HILOGD(COMP_SVC, "Get gnss on timer for uid: %{public}d", uid);
+    return GetTimerStore().GetTimer(StatsTimerStore::TIMER_KIND_GNSS_ON, uid);
 }
 
 void GnssEntity::Reset()
 {
-    // Reset app Gnss on total power consumption
-    for (auto& iter : gnssPowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
-
-    // Reset Gnss on timer
-    for (auto& iter : gnssTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
+    // Reset app Gnss on timer and power consumption
+    GetTimerStore().Reset(StatsTimerStore::TIMER_KIND_GNSS_ON);
 }
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file
@@ -118,10 +118,7 @@ void PhoneEntity::Calculate(int32_t uid)
     }
     phonePowerMah_ = phoneOnPowerMah + phoneDataPowerMah;
     totalPowerMah_ += phonePowerMah_;
-    std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-    statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_PHONE);
-    statsInfo->SetPower(phonePowerMah_);
-    statsInfoList_.push_back(statsInfo);
+    AddStatsResult(BatteryStatsInfo::CONSUMPTION_TYPE_PHONE, phonePowerMah_);
     STATS_HILOGD(COMP_SVC, "Calculate phone active power consumption: %{public}lfmAh", phonePowerMah_);
 }
 
@@ -152,7 +149,7 @@ std::shared_ptr<StatsHelper::ActiveTimer> PhoneEntity::GetOrCreateTimer(StatsUti
                 break;
             }
             STATS_HILOGD(COMP_SVC, "Create phone on timer for level: %{public}d", level);
-            std::shared_ptr<StatsHelper::ActiveTimer> phoneOnTimer = std::make_shared<StatsHelper::ActiveTimer>();
+            std::shared_ptr<StatsHelper::ActiveTimer> phoneOnTimer = AllocateTimer();
             phoneOnTimerMap_.insert(
                 std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(level, phoneOnTimer));
             timer = phoneOnTimer;
@@ -166,7 +163,7 @@ std::shared_ptr<StatsHelper::ActiveTimer> PhoneEntity::GetOrCreateTimer(StatsUti
                 break;
             }
             STATS_HILOGD(COMP_SVC, "Create phone data timer for level: %{public}d", level);
-            std::shared_ptr<StatsHelper::ActiveTimer> phoneDataTimer = std::make_shared<StatsHelper::ActiveTimer>();
+            std::shared_ptr<StatsHelper::ActiveTimer> phoneDataTimer = AllocateTimer();
             phoneDataTimerMap_.insert(
                 std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(level, phoneDataTimer));
             timer = phoneDataTimer;
@@ -15,7 +15,9 @@
 
 #include "entities/screen_entity.h"
 
+#include <algorithm>
 #include <cinttypes>
+#include <iterator>
 
 #include "battery_stats_service.h"
 #include "stats_log.h"
@@ -24,6 +26,39 @@ namespace OHOS {
 namespace PowerMgr {
 namespace {
 }
+class ScreenEntity::BrightnessTimerView : public StatsHelper::ActiveTimer {
+public:
+    BrightnessTimerView(ScreenEntity* entity, int16_t level) : entity_(entity), level_(level) {}
+    ~BrightnessTimerView() override = default;
+    bool StartRunning() override
+    {
+        return entity_->StartBrightnessTimer(level_);
+    }
+
+    bool StopRunning() override
+    {
+        return entity_->StopBrightnessTimer(level_);
+    }
+
+    int64_t GetRunningTimeMs() override
+    {
+        return entity_->GetBrightnessTimeMs(level_);
+    }
+
+    void AddRunningTimeMs(int64_t avtiveTime) override
+    {
+        entity_->AddBrightnessTimeMs(level_, avtiveTime);
+    }
+
+    void Reset() override
+    {
+        entity_->ResetBrightnessTimer(level_);
+    }
+private:
+    ScreenEntity* entity_;
+    int16_t level_;
+};
+
 ScreenEntity::ScreenEntity()
 {
     consumptionType_ = BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN;
@@ -44,15 +79,10 @@ int64_t ScreenEntity::GetActiveTimeMs(StatsUtils::StatsType statsType, int16_t l
         }
         case StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS: {
             if (level != StatsUtils::INVALID_VALUE) {
-                auto iter = screenBrightnessTimerMap_.find(level);
-                if (iter != screenBrightnessTimerMap_.end() && iter->second != nullptr) {
-                    activeTimeMs = iter->second->GetRunningTimeMs();
-                    STATS_HILOGD(COMP_SVC,
-                        "Get screen brightness time: %{public}" PRId64 "ms of brightness level: %{public}d",
-                        activeTimeMs, level);
-                    break;
-                }
-                STATS_HILOGD(COMP_SVC, "No screen brightness timer found, return 0");
+                activeTimeMs = GetBrightnessTimeMs(level);
+                STATS_HILOGD(COMP_SVC,
+                    "Get screen brightness time: %{public}" PRId64 "ms of brightness level: %{public}d",
+                    activeTimeMs, level);
                 break;
             }
             activeTimeMs = GetBrightnessTotalTimeMs();
@@ -65,15 +95,111 @@ int64_t ScreenEntity::GetActiveTimeMs(StatsUtils::StatsType statsType, int16_t l
     return activeTimeMs;
 }
 
+bool ScreenEntity::StartBrightnessTimer(int16_t level)
+{
+    if (level <= StatsUtils::INVALID_VALUE || level > StatsUtils::SCREEN_BRIGHTNESS_BIN) {
+        STATS_HILOGD(COMP_SVC, "Illegal brightness");
+        return false;
+    }
+    if (runningBrightnessLevel_ == level) {
+        STATS_HILOGD(COMP_SVC, "Screen brightness timer of level: %{public}d was already started", level);
+        return false;
+    }
+    int64_t nowMs = StatsHelper::GetOnBatteryBootTimeMs();
+    if (runningBrightnessLevel_ > StatsUtils::INVALID_VALUE) {
+        brightnessTimeMs_[runningBrightnessLevel_] += nowMs - runningBrightnessStartMs_;
+    }
+    runningBrightnessLevel_ = level;
+    runningBrightnessStartMs_ = nowMs;
+    STATS_HILOGD(COMP_SVC, "Screen brightness timer of level: %{public}d is started", level);
+    return true;
+}
+
+bool ScreenEntity::StopBrightnessTimer(int16_t level)
+{
+    if (runningBrightnessLevel_ <= StatsUtils::INVALID_VALUE ||
+        (level > StatsUtils::INVALID_VALUE && level != runningBrightnessLevel_)) {
+        STATS_HILOGD(COMP_SVC, "No related screen brightness timer is running");
+        return false;
+    }
+    brightnessTimeMs_[runningBrightnessLevel_] += StatsHelper::GetOnBatteryBootTimeMs() - runningBrightnessStartMs_;
+    STATS_HILOGD(COMP_SVC, "Screen brightness timer of level: %{public}d is stopped", runningBrightnessLevel_);
+    runningBrightnessLevel_ = StatsUtils::INVALID_VALUE;
+    return true;
+}
+
+void ScreenEntity::FoldRunningBrightnessTime()
+{
+    if (runningBrightnessLevel_ <= StatsUtils::INVALID_VALUE) {
+        return;
+    }
+    int64_t nowMs = StatsHelper::GetOnBatteryBootTimeMs();
+    brightnessTimeMs_[runningBrightnessLevel_] += nowMs - runningBrightnessStartMs_;
+    runningBrightnessStartMs_ = nowMs;
+}
+
+void ScreenEntity::GetBrightnessTimesMs(int64_t (&timesMs)[BRIGHTNESS_LEVEL_COUNT])
+{
+    FoldRunningBrightnessTime();
+    std::copy(std::begin(brightnessTimeMs_), std::end(brightnessTimeMs_), std::begin(timesMs));
+}
+
+int64_t ScreenEntity::GetBrightnessTimeMs(int16_t level)
+{
+    if (level <= StatsUtils::INVALID_VALUE || level > StatsUtils::SCREEN_BRIGHTNESS_BIN) {
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    if (level == runningBrightnessLevel_) {
+        FoldRunningBrightnessTime();
+    }
+    return brightnessTimeMs_[level];
+}
+
 int64_t ScreenEntity::GetBrightnessTotalTimeMs()
 {
+    FoldRunningBrightnessTime();
     int64_t totalTimeMs = StatsUtils::DEFAULT_VALUE;
-    for (auto timerIter : screenBrightnessTimerMap_) {
-        totalTimeMs += timerIter.second->GetRunningTimeMs();
+    for (int32_t level = 0; level < BRIGHTNESS_LEVEL_COUNT; level++) {
+        totalTimeMs += brightnessTimeMs_[level];
     }
     return totalTimeMs;
 }
 
+void ScreenEntity::AddBrightnessTimeMs(int16_t level, int64_t activeTimeMs)
+{
+    if (level <= StatsUtils::INVALID_VALUE || level > StatsUtils::SCREEN_BRIGHTNESS_BIN ||
+        activeTimeMs <= StatsUtils::DEFAULT_VALUE) {
+        STATS_HILOGW(COMP_SVC, "Invalid brightness level or active time, ignore");
+        return;
+    }
+    brightnessTimeMs_[level] += activeTimeMs;
+}
+
+void ScreenEntity::ResetBrightnessTimer(int16_t level)
+{
+    if (level <= StatsUtils::INVALID_VALUE || level > StatsUtils::SCREEN_BRIGHTNESS_BIN) {
+        return;
+    }
+    // Like the other timers the reset stops a running level, its open interval is dropped
+    if (level == runningBrightnessLevel_) {
+        runningBrightnessLevel_ = StatsUtils::INVALID_VALUE;
+        runningBrightnessStartMs_ = StatsHelper::GetOnBatteryBootTimeMs();
+    }
+    brightnessTimeMs_[level] = StatsUtils::DEFAULT_VALUE;
+    STATS_HILOGD(COMP_SVC, "Reset screen brightness timer of level: %{public}d", level);
+}
+
+void ScreenEntity::UpdateBrightnessLevelMa(double brightnessAverageMa)
+{
+    if (brightnessAverageMa == brightnessAverageMa_) {
+        return;
+    }
+    for (int32_t level = 0; level < BRIGHTNESS_LEVEL_COUNT; level++) {
+        brightnessLevelMa_[level] = brightnessAverageMa * level;
+    }
+    brightnessAverageMa_ = brightnessAverageMa;
+}
+
 void ScreenEntity::Calculate(int32_t uid)
 {
     auto bss = BatteryStatsService::GetInstance();
@@ -82,23 +208,15 @@ void ScreenEntity::Calculate(int32_t uid)
     auto screenOnTimeMs = GetActiveTimeMs(StatsUtils::STATS_TYPE_SCREEN_ON);
     double screenOnPowerMah = screenOnAverageMa * screenOnTimeMs;
 
-    auto brightnessAverageMa =
-        bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_SCREEN_BRIGHTNESS);
-    double brightnessPowerMah = StatsUtils::DEFAULT_VALUE;
-    for (auto& iter : screenBrightnessTimerMap_) {
-        if (iter.second != nullptr) {
-            auto averageMa = brightnessAverageMa * iter.first;
-            auto timeMs = GetActiveTimeMs(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, iter.first);
-            brightnessPowerMah += averageMa * timeMs;
-        }
-    }
+    UpdateBrightnessLevelMa(
+        bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_SCREEN_BRIGHTNESS));
+    FoldRunningBrightnessTime();
+    // Same partial sum reduction as the cpu speed power, over the contiguous per-level arrays
+    double brightnessPowerMah = StatsUtils::DotProduct(brightnessTimeMs_, brightnessLevelMa_, BRIGHTNESS_LEVEL_COUNT);
 
     screenPowerMah_ = (screenOnPowerMah + brightnessPowerMah) / StatsUtils::MS_IN_HOUR;
     totalPowerMah_ += screenPowerMah_;
-    std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-    statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN);
-    statsInfo->SetPower(screenPowerMah_);
-    statsInfoList_.push_back(statsInfo);
+    AddStatsResult(BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN, screenPowerMah_);
     STATS_HILOGD(COMP_SVC, "Calculate screen active power consumption: %{public}lfmAh", screenPowerMah_);
 }
 
@@ -123,7 +241,7 @@ std::shared_ptr<StatsHelper::ActiveTimer> ScreenEntity::GetOrCreateTimer(StatsUt
                 break;
             }
             STATS_HILOGD(COMP_SVC, "Create screen on timer");
-            screenOnTimer_ = std::make_shared<StatsHelper::ActiveTimer>();
+            screenOnTimer_ = AllocateTimer();
             timer = screenOnTimer_;
             break;
         }
@@ -132,17 +250,11 @@ std::shared_ptr<StatsHelper::ActiveTimer> ScreenEntity::GetOrCreateTimer(StatsUt
                 STATS_HILOGD(COMP_SVC, "Illegal brightness");
                 break;
             }
-            auto iter = screenBrightnessTimerMap_.find(level);
-            if (iter != screenBrightnessTimerMap_.end() && iter->second != nullptr) {
-                STATS_HILOGD(COMP_SVC, "Get screen brightness timer of brightness level: %{public}d", level);
-                timer = iter->second;
-                break;
+            STATS_HILOGD(COMP_SVC, "Get screen brightness timer of brightness level: %{public}d", level);
+            if (brightnessTimers_[level] == nullptr) {
+                brightnessTimers_[level] = std::make_shared<BrightnessTimerView>(this, level);
             }
-            STATS_HILOGD(COMP_SVC, "Create screen brightness timer of brightness level: %{public}d", level);
-            std::shared_ptr<StatsHelper::ActiveTimer> brightnessTimer = std::make_shared<StatsHelper::ActiveTimer>();
-            screenBrightnessTimerMap_.insert(
-                std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(level, brightnessTimer));
-            timer = brightnessTimer;
+            timer = brightnessTimers_[level];
             break;
         }
         default:
@@ -162,12 +274,10 @@ void ScreenEntity::Reset()
         screenOnTimer_->Reset();
     }
 
-    // Reset Screen brightness timer
-    for (auto& iter : screenBrightnessTimerMap_) {
-        if (iter.second != nullptr) {
-            iter.second->Reset();
-        }
-    }
+    // Reset Screen brightness time
+    std::fill(std::begin(brightnessTimeMs_), std::end(brightnessTimeMs_), StatsUtils::DEFAULT_VALUE);
+    runningBrightnessLevel_ = StatsUtils::INVALID_VALUE;
+    runningBrightnessStartMs_ = StatsHelper::GetOnBatteryBootTimeMs();
 }
 
 void ScreenEntity::DumpInfo(std::string& result, int32_t uid)
@@ -23,9 +23,10 @@
 #include <sys_mgr_client.h>
 #endif
 
-#include <ohos_account_kits_impl.h>
+#include <algorithm>
 #include "battery_stats_service.h"
 #include "stats_log.h"
+#include "stats_uid_interner.h"
 
 namespace OHOS {
 namespace PowerMgr {
@@ -39,26 +40,24 @@ UidEntity::UidEntity()
 
 void UidEntity::UpdateUidMap(int32_t uid)
 {
-    std::lock_guard<std::mutex> lock(uidEntityMutex_);
     if (uid > StatsUtils::INVALID_VALUE) {
-        auto iter = uidPowerMap_.find(uid);
-        if (iter != uidPowerMap_.end()) {
-            STATS_HILOGD(COMP_SVC, "Uid has already been added, ignore");
-        } else {
-            STATS_HILOGD(COMP_SVC, "Update %{public}d to uid power map", uid);
-            uidPowerMap_.insert(std::pair<int32_t, double>(uid, StatsUtils::DEFAULT_VALUE));
-        }
+        StatsUidInterner::GetInstance().Intern(uid);
     }
 }
 
 std::vector<int32_t> UidEntity::GetUids()
 {
-    std::lock_guard<std::mutex> lock(uidEntityMutex_);
-    std::vector<int32_t> uids;
-    std::transform(uidPowerMap_.begin(), uidPowerMap_.end(), std::back_inserter(uids), [](const auto& item) {
-        return item.first;
-    });
-    return uids;
+    return StatsUidInterner::GetInstance().GetUids();
+}
+
+void UidEntity::SyncUidIndexes()
+{
+    // Every interned uid is an app uid, whichever module saw it first
+    uint32_t count = StatsUidInterner::GetInstance().GetCount();
+    if (count > uidPowerMah_.size()) {
+        uidPowerMah_.resize(count, StatsUtils::DEFAULT_VALUE);
+        uidUserIds_.resize(count, StatsUtils::INVALID_VALUE);
+    }
 }
 
 double UidEntity::CalculateForConnectivity(int32_t uid)
@@ -104,8 +103,7 @@ double UidEntity::CalculateForCommon(int32_t uid)
     // Calculate gnss power consumption
     gnssEntity->Calculate(uid);
     power += gnssEntity->GetEntityPowerMah(uid);
-    // Calculate cpu power consumption
-    cpuEntity->Calculate(uid);
+    // Cpu power consumption of all uids is calculated in one batch before
     power += cpuEntity->GetEntityPowerMah(uid);
     // Calculate cpu power consumption
     wakelockEntity->Calculate(uid);
@@ -124,37 +122,57 @@ void UidEntity::Calculate(int32_t uid)
     std::lock_guard<std::mutex> lock(uidEntityMutex_);
     auto core = bss->GetBatteryStatsCore();
     auto userEntity = core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_USER);
-    for (auto& iter : uidPowerMap_) {
+    auto topConsumers = core->GetStatsTopConsumers();
+    auto& interner = StatsUidInterner::GetInstance();
+    core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_CPU)->Calculate();
+    SyncUidIndexes();
+    // An invalidated heap is rebuilt from every uid, not only the changed ones
+    bool isRebuild = topConsumers->TakeInvalidated();
+    for (uint32_t index = 0; index < uidPowerMah_.size(); index++) {
+        int32_t uid = interner.GetUid(index);
         double power = StatsUtils::DEFAULT_VALUE;
-        power += CalculateForConnectivity(iter.first);
-        power += CalculateForCommon(iter.first);
-        iter.second = power;
-        totalPowerMah_ += power;
-        AddtoStatsList(iter.first, power);
-        int32_t uid = iter.first;
-        int32_t userId = AccountSA::OhosAccountKits::GetInstance().GetDeviceAccountIdByUID(uid);
+        power += CalculateForConnectivity(uid);
+        power += CalculateForCommon(uid);
         if (userEntity != nullptr) {
-            userEntity->AggregateUserPowerMah(userId, power);
+            UpdateUserPowerMah(userEntity, index, interner.GetUserId(uid), power);
+        }
+        if (isRebuild || power != uidPowerMah_[index]) {
+            topConsumers->Update(index, power);
         }
+        uidPowerMah_[index] = power;
+        totalPowerMah_ += power;
+        AddtoStatsList(uid, power);
     }
 }
 
+void UidEntity::UpdateUserPowerMah(const std::shared_ptr<BatteryStatsEntity>& userEntity, uint32_t index,
+    int32_t userId, double power)
+{
+    // Only the change since the last calculation is handed over, so user totals never get re-aggregated
+    double lastPower = uidPowerMah_[index];
+    int32_t lastUserId = uidUserIds_[index];
+    if (lastUserId != userId) {
+        if (lastUserId != StatsUtils::INVALID_VALUE) {
+            userEntity->AggregateUserPowerMah(lastUserId, -lastPower);
+        }
+        lastPower = StatsUtils::DEFAULT_VALUE;
+        uidUserIds_[index] = userId;
+    }
+    userEntity->AggregateUserPowerMah(userId, power - lastPower);
+}
+
 void UidEntity::AddtoStatsList(int32_t uid, double power)
 {
-    std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-    statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
-    statsInfo->SetUid(uid);
-    statsInfo->SetPower(power);
-    statsInfoList_.push_back(statsInfo);
+    AddStatsResult(BatteryStatsInfo::CONSUMPTION_TYPE_APP, power, uid);
 }
 
 double UidEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     std::lock_guard<std::mutex> lock(uidEntityMutex_);
     double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = uidPowerMap_.find(uidOrUserId);
-    if (iter != uidPowerMap_.end()) {
-        power = iter->second;
+    uint32_t index = 0;
+    if (StatsUidInterner::GetInstance().Find(uidOrUserId, index) && index < uidPowerMah_.size()) {
+        power = uidPowerMah_[index];
         STATS_HILOGD(COMP_SVC, "Get app uid power consumption: %{public}lfmAh for uid: %{public}d",
             power, uidOrUserId);
     } else {
@@ -255,9 +273,7 @@ void UidEntity::Reset()
 {
     std::lock_guard<std::mutex> lock(uidEntityMutex_);
     // Reset app Uid total power consumption
-    for (auto& iter : uidPowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
-    }
+    std::fill(uidPowerMah_.begin(), uidPowerMah_.end(), StatsUtils::DEFAULT_VALUE);
 }
 
 void UidEntity::DumpForBluetooth(int32_t uid, std::string& result)
@@ -335,7 +351,7 @@ void UidEntity::DumpInfo(std::string& result, int32_t uid)
     auto bss = BatteryStatsService::GetInstance();
     std::lock_guard<std::mutex> lock(uidEntityMutex_);
     auto core = bss->GetBatteryStatsCore();
-    for (auto& iter : uidPowerMap_) {
+    for (int32_t uid : StatsUidInterner::GetInstance().GetUids()) {
         std::string bundleName = "NULL";
 #ifdef SYS_MGR_CLIENT_ENABLE
         auto bundleObj =
@@ -349,27 +365,27 @@ void UidEntity::DumpInfo(std::string& result, int32_t uid)
                 STATS_HILOGE(COMP_SVC, "Failed to get bundle manager proxy");
             } else {
                 std::string identity = IPCSkeleton::ResetCallingIdentity();
-                ErrCode res = bmgr->GetNameForUid(iter.first, bundleName);
+                ErrCode res = bmgr->GetNameForUid(uid, bundleName);
                 IPCSkeleton::SetCallingIdentity(identity);
                 if (res != ERR_OK) {
                     STATS_HILOGE(COMP_SVC, "Failed to get bundle name for uid=%{public}d, ErrCode=%{public}d",
-                        iter.first, static_cast<int32_t>(res));
+                        uid, static_cast<int32_t>(res));
                 }
             }
         }
 #endif
         result.append("\n")
-            .append(ToString(iter.first))
+            .append(ToString(uid))
             .append("(Bundle name: ")
             .append(bundleName)
             .append(")")
             .append(":")
             .append("\n");
-        DumpForBluetooth(iter.first, result);
-        DumpForCommon(iter.first, result);
+        DumpForBluetooth(uid, result);
+        DumpForCommon(uid, result);
         auto cpuEntity = core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_CPU);
         if (cpuEntity) {
-            cpuEntity->DumpInfo(result, iter.first);
+            cpuEntity->DumpInfo(result, uid);
         }
     }
 }
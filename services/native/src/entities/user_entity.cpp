@@ -15,7 +15,6 @@
 
 #include "entities/user_entity.h"
 
-#include "ohos_account_kits_impl.h"
 #include "stats_log.h"
 
 #include "battery_stats_parser.h"
@@ -51,7 +50,7 @@ void UserEntity::AggregateUserPowerMah(int32_t userId, double power)
     auto iter = userPowerMap_.find(userId);
     if (iter != userPowerMap_.end()) {
         iter->second += power;
-        STATS_HILOGD(COMP_SVC, "Add user power consumption: %{public}lfmAh for user id: %{public}d",
+        STATS_HILOGD(COMP_SVC, "Update user power consumption by %{public}lfmAh for user id: %{public}d",
             power, userId);
     } else {
         STATS_HILOGD(COMP_SVC, "Create user power consumption: %{public}lfmAh for user id: %{public}d",
@@ -63,11 +62,7 @@ void UserEntity::AggregateUserPowerMah(int32_t userId, double power)
 void UserEntity::Calculate(int32_t uid)
 {
     for (auto& iter : userPowerMap_) {
-        std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-        statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_USER);
-        statsInfo->SetUserId(iter.first);
-        statsInfo->SetPower(iter.second);
-        statsInfoList_.push_back(statsInfo);
+        AddStatsResult(BatteryStatsInfo::CONSUMPTION_TYPE_USER, iter.second, StatsUtils::INVALID_VALUE, iter.first);
     }
 }
 
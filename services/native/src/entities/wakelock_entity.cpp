@@ -15,6 +15,7 @@
 
 #include "entities/wakelock_entity.h"
 
+#include <algorithm>
 #include <cinttypes>
 
 #include "battery_stats_service.h"
@@ -23,6 +24,7 @@
 namespace OHOS {
 namespace PowerMgr {
 namespace {
+constexpr size_t DUMP_WAKELOCK_COUNT = 10;
 }
 
 WakelockEntity::WakelockEntity()
@@ -37,13 +39,8 @@ int64_t WakelockEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType stats
         return activeTimeMs;
     }
 
-    auto iter = wakelockTimerMap_.find(uid);
-    if (iter != wakelockTimerMap_.end()) {
-        activeTimeMs = iter->second->GetRunningTimeMs();
-        STATS_HILOGD(COMP_SVC, "Get wakelock on time: %{public}" PRId64 "ms for uid: %{public}d", activeTimeMs, uid);
-        return activeTimeMs;
-    }
-    STATS_HILOGD(COMP_SVC, "Didn't find related timer for uid: %{public}d, return 0", uid);
+    activeTimeMs = GetTimerStore().GetRunningTimeMs(StatsTimerStore::TIMER_KIND_WAKELOCK_HOLD, uid);
+    STATS_HILOGD(COMP_SVC, "Get wakelock on time: %{public}" PRId64 "ms for uid: %{public}d", activeTimeMs, uid);
     return activeTimeMs;
 }
 
@@ -54,30 +51,16 @@ void WakelockEntity::Calculate(int32_t uid)
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_CPU_AWAKE);
     auto wakelockOnTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_WAKELOCK_HOLD);
     auto wakelockOnPowerMah = wakelockOnAverageMa * wakelockOnTimeMs / StatsUtils::MS_IN_HOUR;
-    auto iter = wakelockPowerMap_.find(uid);
-    if (iter != wakelockPowerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Update wakelock on power consumption: %{public}lfmAh for uid: %{public}d",
-            wakelockOnPowerMah, uid);
-        iter->second = wakelockOnPowerMah;
-    } else {
-        STATS_HILOGD(COMP_SVC, "Create wakelock on power consumption: %{public}lfmAh for uid: %{public}d",
-            wakelockOnPowerMah, uid);
-        wakelockPowerMap_.insert(std::pair<int32_t, double>(uid, wakelockOnPowerMah));
-    }
+    STATS_HILOGD(COMP_SVC, "Update wakelock on power consumption: %{public}lfmAh for uid: %{public}d",
+        wakelockOnPowerMah, uid);
+    GetTimerStore().SetPowerMah(StatsTimerStore::TIMER_KIND_WAKELOCK_HOLD, uid, wakelockOnPowerMah);
 }
 
 double WakelockEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
-    double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = wakelockPowerMap_.find(uidOrUserId);
-    if (iter != wakelockPowerMap_.end()) {
-        power = iter->second;
-        STATS_HILOGD(COMP_SVC, "Get app wakelock power consumption: %{public}lfmAh for uid: %{public}d",
-            power, uidOrUserId);
-    } else {
-        STATS_HILOGD(COMP_SVC,
-            "No app wakelock power consumption related to uid: %{public}d was found, return 0", uidOrUserId);
-    }
+    double power = GetTimerStore().GetPowerMah(StatsTimerStore::TIMER_KIND_WAKELOCK_HOLD, uidOrUserId);
+    STATS_HILOGD(COMP_SVC, "Get app wakelock power consumption: %{public}lfmAh for uid: %{public}d",
+        power, uidOrUserId);
     return power;
 }
 
@@ -85,15 +68,9 @@ double WakelockEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_WAKELOCK_HOLD) {
-        auto wakelockOnIter = wakelockPowerMap_.find(uid);
-        if (wakelockOnIter != wakelockPowerMap_.end()) {
-            power = wakelockOnIter->second;
-            STATS_HILOGD(COMP_SVC, "Get wakelock on power consumption: %{public}lfmAh for uid: %{public}d",
-                power, uid);
-        } else {
-            STATS_HILOGD(COMP_SVC,
-                "No wakelock on power consumption related to uid: %{public}d was found, return 0", uid);
-        }
+        power = GetTimerStore().GetPowerMah(StatsTimerStore::TIMER_KIND_WAKELOCK_HOLD, uid);
+        STATS_HILOGD(COMP_SVC, "Get wakelock on power consumption: %{public}lfmAh for uid: %{public}d",
+            power, uid);
     }
     return power;
 }
@@ -104,31 +81,87 @@ std::shared_ptr<StatsHelper::ActiveTimer> WakelockEntity::GetOrCreateTimer(int32
     if (statsType != StatsUtils::STATS_TYPE_WAKELOCK_HOLD) {
         return nullptr;
     }
+    STATS_HILOGD(COMP_SVC, "Get wakelock on timer for uid: %{public}d", uid);
+    return GetTimerStore().GetTimer(StatsTimerStore::TIMER_KIND_WAKELOCK_HOLD, uid);
+}
+
+void WakelockEntity::Reset()
+{
+    STATS_HILOGI(COMP_SVC, "Reset Wakelock on timer.");
+    // Reset app Wakelock on timer and power consumption
+    GetTimerStore().Reset(StatsTimerStore::TIMER_KIND_WAKELOCK_HOLD);
+    GetTimerStore().ResetNamed();
+}
 
-    auto wakelockOnIter = wakelockTimerMap_.find(uid);
-    if (wakelockOnIter != wakelockTimerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Get wakelock on timer for uid: %{public}d", uid);
-        return wakelockOnIter->second;
+uint32_t WakelockEntity::InternLockName(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(lockNameMutex_);
+    auto iter = lockNameIds_.find(name);
+    if (iter != lockNameIds_.end()) {
+        return iter->second;
+    }
+    if (lockNames_.size() >= MAX_LOCK_NAMES) {
+        STATS_HILOGD(COMP_SVC, "Lock name table is full, count %{public}s as other", name.c_str());
+        return StatsTimerStore::NAME_ID_OTHER;
     }
-    STATS_HILOGD(COMP_SVC, "Create wakelock on timer for uid: %{public}d", uid);
-    std::shared_ptr<StatsHelper::ActiveTimer> holdTimer = std::make_shared<StatsHelper::ActiveTimer>();
-    wakelockTimerMap_.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, holdTimer));
-    return holdTimer;
+    uint32_t nameId = static_cast<uint32_t>(lockNames_.size());
+    lockNames_.push_back(name);
+    lockNameIds_.insert(std::pair<std::string, uint32_t>(name, nameId));
+    return nameId;
 }
 
-void WakelockEntity::Reset()
+std::string WakelockEntity::GetLockName(uint32_t nameId)
 {
-    // Reset app Wakelock on total power consumption
-    for (auto& iter : wakelockPowerMap_) {
-        iter.second = StatsUtils::DEFAULT_VALUE;
+    std::lock_guard<std::mutex> lock(lockNameMutex_);
+    return nameId < lockNames_.size() ? lockNames_[nameId] : lockNames_[StatsTimerStore::NAME_ID_OTHER];
+}
+
+void WakelockEntity::UpdateLockName(StatsUtils::StatsState state, int32_t uid, const std::string& name,
+    bool isAllHolders)
+{
+    if (uid <= StatsUtils::INVALID_VALUE) {
+        return;
+    }
+    uint32_t nameId = InternLockName(name);
+    if (state == StatsUtils::STATS_STATE_ACTIVATED) {
+        GetTimerStore().StartNamedRunning(uid, nameId);
+    } else if (state == StatsUtils::STATS_STATE_DEACTIVATED) {
+        GetTimerStore().StopNamedRunning(uid, nameId, isAllHolders);
     }
+}
 
-    STATS_HILOGI(COMP_SVC, "Reset Wakelock on timer.");
-    // Reset Wakelock on timer
-    for (auto& iter : wakelockTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
+std::vector<WakelockHoldTime> WakelockEntity::GetTopWakelocks(size_t count)
+{
+    auto namedTimes = GetTimerStore().GetNamedTimes();
+    size_t topCount = std::min(count, namedTimes.size());
+    std::partial_sort(namedTimes.begin(), namedTimes.begin() + topCount, namedTimes.end(),
+        [](const StatsTimerStore::NamedTime& first, const StatsTimerStore::NamedTime& second) {
+            return first.totalTimeMs > second.totalTimeMs;
+        });
+    std::vector<WakelockHoldTime> topWakelocks;
+    topWakelocks.reserve(topCount);
+    for (size_t i = 0; i < topCount; i++) {
+        topWakelocks.push_back({namedTimes[i].uid, GetLockName(namedTimes[i].nameId), namedTimes[i].totalTimeMs});
+    }
+    return topWakelocks;
+}
+
+void WakelockEntity::GetHoldTimesMs(std::vector<int64_t>& holdTimesMs)
+{
+    // Indexed by the dense uid index of StatsUidInterner
+    GetTimerStore().GetTotalTimesMs(StatsTimerStore::TIMER_KIND_WAKELOCK_HOLD, holdTimesMs);
+}
+
+void WakelockEntity::DumpInfo(std::string& result, int32_t uid)
+{
+    result.append("Top wakelocks by hold time:\n");
+    for (const auto& wakelock : GetTopWakelocks(DUMP_WAKELOCK_COUNT)) {
+        result.append(ToString(wakelock.uid))
+            .append(" ")
+            .append(wakelock.name)
+            .append(": ")
+            .append(ToString(wakelock.holdTimeMs))
+            .append("ms\n");
     }
 }
 } // namespace PowerMgr
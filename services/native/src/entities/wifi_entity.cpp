@@ -45,10 +45,7 @@ void WifiEntity::Calculate(int32_t uid)
 
     wifiPowerMah_ = wifiOnPowerMah + wifiScanPowerMah;
     totalPowerMah_ += wifiPowerMah_;
-    std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-    statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_WIFI);
-    statsInfo->SetPower(wifiPowerMah_);
-    statsInfoList_.push_back(statsInfo);
+    AddStatsResult(BatteryStatsInfo::CONSUMPTION_TYPE_WIFI, wifiPowerMah_);
     STATS_HILOGD(COMP_SVC, "Calculate wifi power consumption: %{public}lfmAh", wifiPowerMah_);
 }
 
@@ -102,7 +99,7 @@ std::shared_ptr<StatsHelper::ActiveTimer> WifiEntity::GetOrCreateTimer(StatsUtil
         STATS_HILOGD(COMP_SVC, "Get wifi on timer");
         return wifiOnTimer_;
     }
-    wifiOnTimer_ = std::make_shared<StatsHelper::ActiveTimer>();
+    wifiOnTimer_ = AllocateTimer();
     return wifiOnTimer_;
 }
 
@@ -116,7 +113,7 @@ std::shared_ptr<StatsHelper::Counter> WifiEntity::GetOrCreateCounter(StatsUtils:
         return wifiScanCounter_;
     }
     STATS_HILOGD(COMP_SVC, "Create wifi scan counter");
-    wifiScanCounter_ = std::make_shared<StatsHelper::Counter>();
+    wifiScanCounter_ = AllocateCounter();
     return wifiScanCounter_;
 }
 
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pid_cpu_time_reader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <dirent.h>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "string_ex.h"
+
+#include "stats_log.h"
+#include "stats_utils.h"
+
+namespace OHOS {
+namespace PowerMgr {
+namespace {
+// Layout of the records returned by getdents64
+struct LinuxDirent64 {
+    uint64_t ino;
+    int64_t off;
+    uint16_t reclen;
+    uint8_t type;
+    char name[];
+};
+// Fields of /proc/[pid]/stat counted from the state, the first one after the command name
+constexpr uint32_t STAT_UTIME_FIELD = 11;
+constexpr uint32_t STAT_STIME_FIELD = 12;
+constexpr uint32_t STAT_START_TIME_FIELD = 19;
+constexpr int64_t DEFAULT_TICKS_PER_SECOND = 100;
+constexpr size_t DIRENT_BUFFER_SIZE = 32 * 1024;
+constexpr size_t FILE_BUFFER_SIZE = 4 * 1024;
+
+bool ParsePid(const char* name, int32_t& pid)
+{
+    const char* end = name;
+    while (*end >= '0' && *end <= '9') {
+        end++;
+    }
+    if (end == name || *end != '\0') {
+        return false;
+    }
+    return std::from_chars(name, end, pid).ec == std::errc();
+}
+} // namespace
+
+PidCpuTimeReader::PidCpuTimeReader()
+{
+    long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    ticksPerSecond_ = ticksPerSecond > 0 ? ticksPerSecond : DEFAULT_TICKS_PER_SECOND;
+    direntBuffer_.resize(DIRENT_BUFFER_SIZE);
+    fileBuffer_.resize(FILE_BUFFER_SIZE);
+}
+
+void PidCpuTimeReader::SetProcRoot(const std::string& procRoot)
+{
+    procRoot_ = procRoot;
+    baselines_.clear();
+}
+
+bool PidCpuTimeReader::Scan()
+{
+    auto begin = std::chrono::steady_clock::now();
+    int32_t dirFd = open(procRoot_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+        STATS_HILOGW(COMP_SVC, "Open proc dir failed, errno: %{public}d", errno);
+        return false;
+    }
+    generation_++;
+    uidIncrements_.clear();
+    bool isComplete = true;
+    while (true) {
+        long count = syscall(SYS_getdents64, dirFd, direntBuffer_.data(), direntBuffer_.size());
+        if (count < 0) {
+            STATS_HILOGW(COMP_SVC, "Read proc dir failed, errno: %{public}d", errno);
+            isComplete = false;
+            break;
+        }
+        if (count == 0) {
+            break;
+        }
+        for (long offset = 0; offset < count;) {
+            auto entry = reinterpret_cast<const LinuxDirent64*>(direntBuffer_.data() + offset);
+            offset += entry->reclen;
+            int32_t pid = 0;
+            if ((entry->type == DT_DIR || entry->type == DT_UNKNOWN) && ParsePid(entry->name, pid)) {
+                // A process may exit while the directory is scanned, its files are then gone
+                ReadPid(dirFd, entry->name, pid);
+            }
+        }
+    }
+    close(dirFd);
+    // After a partial scan the pids not reached keep their baselines, the next scan charges their time
+    if (isComplete) {
+        RemoveExitedPids();
+    }
+    ConvertIncrements();
+    scanTimeUs_ = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    return true;
+}
+
+bool PidCpuTimeReader::ReadPid(int32_t dirFd, const char* name, int32_t pid)
+{
+    size_t size = 0;
+    int64_t userTicks = 0;
+    int64_t systemTicks = 0;
+    int64_t startTime = 0;
+    if (!ReadPidFile(dirFd, name, "stat", size) || !ParseStat(size, userTicks, systemTicks, startTime)) {
+        return false;
+    }
+
+    auto [iter, isNew] = baselines_.try_emplace(pid);
+    PidBaseline& baseline = iter->second;
+    int64_t userIncrement = userTicks;
+    int64_t systemIncrement = systemTicks;
+    // A new pid, or one reused by another process since the last scan, is charged all of its time
+    if (!isNew && baseline.startTime == startTime) {
+        userIncrement = std::max<int64_t>(userTicks - baseline.userTicks, 0);
+        systemIncrement = std::max<int64_t>(systemTicks - baseline.systemTicks, 0);
+    }
+    baseline.startTime = startTime;
+    baseline.userTicks = userTicks;
+    baseline.systemTicks = systemTicks;
+    baseline.generation = generation_;
+    if (userIncrement == 0 && systemIncrement == 0) {
+        return true;
+    }
+
+    // The owner only matters when there is time to charge, so idle processes skip their status file
+    int32_t uid = StatsUtils::INVALID_VALUE;
+    if (!ReadPidFile(dirFd, name, "status", size) || !ParseStatusUid(size, uid)) {
+        return false;
+    }
+    auto& uidTime = uidIncrements_[uid];
+    uidTime.userTimeMs += userIncrement;
+    uidTime.systemTimeMs += systemIncrement;
+    return true;
+}
+
+bool PidCpuTimeReader::ReadPidFile(int32_t dirFd, const char* name, const char* file, size_t& size)
+{
+    path_.assign(name).append("/").append(file);
+    int32_t fd = openat(dirFd, path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    size = 0;
+    bool result = true;
+    while (true) {
+        if (size == fileBuffer_.size()) {
+            fileBuffer_.resize(fileBuffer_.size() * 2);
+        }
+        ssize_t count = read(fd, fileBuffer_.data() + size, fileBuffer_.size() - size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            result = count == 0;
+            break;
+        }
+        size += static_cast<size_t>(count);
+    }
+    close(fd);
+    return result;
+}
+
+bool PidCpuTimeReader::ParseStat(size_t size, int64_t& userTicks, int64_t& systemTicks, int64_t& startTime) const
+{
+    // The command name may hold spaces and parentheses, the fields start after its last ')'
+    const char* begin = fileBuffer_.data();
+    const char* end = begin + size;
+    const char* pos = end;
+    while (pos > begin && *(pos - 1) != ')') {
+        pos--;
+    }
+    if (pos == begin) {
+        return false;
+    }
+    for (uint32_t field = 0; field <= STAT_START_TIME_FIELD; field++) {
+        while (pos < end && *pos == ' ') {
+            pos++;
+        }
+        const char* tokenEnd = pos;
+        while (tokenEnd < end && *tokenEnd != ' ' && *tokenEnd != '\n') {
+            tokenEnd++;
+        }
+        if (tokenEnd == pos) {
+            return false;
+        }
+        int64_t* value = nullptr;
+        if (field == STAT_UTIME_FIELD) {
+            value = &userTicks;
+        } else if (field == STAT_STIME_FIELD) {
+            value = &systemTicks;
+        } else if (field == STAT_START_TIME_FIELD) {
+            value = &startTime;
+        }
+        if (value != nullptr && std::from_chars(pos, tokenEnd, *value).ec != std::errc()) {
+            return false;
+        }
+        pos = tokenEnd;
+    }
+    return true;
+}
+
+bool PidCpuTimeReader::ParseStatusUid(size_t size, int32_t& uid) const
+{
+    // "Uid:" is followed by the real, effective, saved and filesystem uid, the real one owns the process
+    std::string_view status(fileBuffer_.data(), size);
+    size_t pos = status.find("\nUid:");
+    if (pos == std::string_view::npos) {
+        return false;
+    }
+    pos = status.find_first_not_of(" \t", pos + std::string_view("\nUid:").size());
+    if (pos == std::string_view::npos) {
+        return false;
+    }
+    return std::from_chars(status.data() + pos, status.data() + status.size(), uid).ec == std::errc();
+}
+
+void PidCpuTimeReader::RemoveExitedPids()
+{
+    exitedCount_ = 0;
+    for (auto iter = baselines_.begin(); iter != baselines_.end();) {
+        if (iter->second.generation != generation_) {
+            iter = baselines_.erase(iter);
+            exitedCount_++;
+        } else {
+            iter++;
+        }
+    }
+}
+
+void PidCpuTimeReader::ConvertIncrements()
+{
+    for (auto& [uid, uidTime] : uidIncrements_) {
+        uidTime.userTimeMs = uidTime.userTimeMs * StatsUtils::MS_IN_SECOND / ticksPerSecond_;
+        uidTime.systemTimeMs = uidTime.systemTimeMs * StatsUtils::MS_IN_SECOND / ticksPerSecond_;
+    }
+}
+
+const std::unordered_map<int32_t, PidCpuTimeReader::UidCpuTime>& PidCpuTimeReader::GetUidIncrements() const
+{
+    return uidIncrements_;
+}
+
+size_t PidCpuTimeReader::GetPidCount() const
+{
+    return baselines_.size();
+}
+
+void PidCpuTimeReader::DumpInfo(std::string& result) const
+{
+    result.append("Pid cpu time fallback: pids=")
+        .append(ToString(baselines_.size()))
+        .append(", exited=")
+        .append(ToString(exitedCount_))
+        .append(", uids=")
+        .append(ToString(uidIncrements_.size()))
+        .append(", scanTime=")
+        .append(ToString(scanTimeUs_))
+        .append("us\n");
+}
+} // namespace PowerMgr
+} // namespace OHOS
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_activation_table.h"
+
+#include <climits>
+
+#include "stats_log.h"
+#include "stats_utils.h"
+
+namespace OHOS {
+namespace PowerMgr {
+namespace {
+// Pid of the aggregate entry of a (uid, resource), never used by a real process
+constexpr int32_t PID_AGGREGATE = INT32_MIN;
+}
+
+StatsActivationTable::StatsActivationTable() : entries_(INITIAL_CAPACITY, Entry {0, 0, 0, 0}) {}
+
+size_t StatsActivationTable::Hash(int32_t uid, int32_t pid, uint32_t resource)
+{
+    uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(uid)) << 32) | static_cast<uint32_t>(pid);
+    key ^= static_cast<uint64_t>(resource) * 0x9E3779B97F4A7C15ULL;
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    return static_cast<size_t>(key);
+}
+
+bool StatsActivationTable::Find(int32_t uid, int32_t pid, uint32_t resource, size_t& pos) const
+{
+    size_t mask = entries_.size() - 1;
+    for (pos = Hash(uid, pid, resource) & mask; entries_[pos].count != 0; pos = (pos + 1) & mask) {
+        const Entry& entry = entries_[pos];
+        if (entry.uid == uid && entry.pid == pid && entry.resource == resource) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t StatsActivationTable::Insert(int32_t uid, int32_t pid, uint32_t resource)
+{
+    size_t pos = 0;
+    if (Find(uid, pid, resource, pos)) {
+        return pos;
+    }
+    // Keep the load factor at most one half so probe sequences stay short
+    if ((entryCount_ + 1) * 2 > entries_.size()) {
+        Grow();
+        Find(uid, pid, resource, pos);
+    }
+    entries_[pos] = {uid, pid, resource, 0};
+    entryCount_++;
+    return pos;
+}
+
+void StatsActivationTable::Erase(size_t pos)
+{
+    size_t mask = entries_.size() - 1;
+    size_t hole = pos;
+    for (size_t next = (pos + 1) & mask; entries_[next].count != 0; next = (next + 1) & mask) {
+        const Entry& entry = entries_[next];
+        size_t home = Hash(entry.uid, entry.pid, entry.resource) & mask;
+        // Shift the entry back unless its home lies cyclically between the hole and itself
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            entries_[hole] = entry;
+            hole = next;
+        }
+    }
+    entries_[hole].count = 0;
+    entryCount_--;
+}
+
+void StatsActivationTable::Grow()
+{
+    std::vector<Entry> oldEntries(entries_.size() * 2, Entry {0, 0, 0, 0});
+    oldEntries.swap(entries_);
+    for (const auto& entry : oldEntries) {
+        if (entry.count == 0) {
+            continue;
+        }
+        size_t pos = 0;
+        Find(entry.uid, entry.pid, entry.resource, pos);
+        entries_[pos] = entry;
+    }
+    STATS_HILOGD(COMP_SVC, "Grow activation table to: %{public}d", static_cast<int32_t>(entries_.size()));
+}
+
+bool StatsActivationTable::Activate(int32_t uid, int32_t pid, uint32_t resource)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t pos = Insert(uid, pid, resource);
+    if (entries_[pos].count++ > 0) {
+        STATS_HILOGD(COMP_SVC, "Nested activation of uid: %{public}d, pid: %{public}d", uid, pid);
+        return false;
+    }
+    pos = Insert(uid, PID_AGGREGATE, resource);
+    return entries_[pos].count++ == 0;
+}
+
+bool StatsActivationTable::Deactivate(int32_t uid, int32_t pid, uint32_t resource)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t pos = 0;
+    if (!Find(uid, pid, resource, pos)) {
+        if (pid == StatsUtils::INVALID_VALUE) {
+            // A stop without a process ends every holder of the uid, like the single timer did
+            return DeactivateUid(uid, resource);
+        }
+        STATS_HILOGD(COMP_SVC, "No live holder of uid: %{public}d, pid: %{public}d", uid, pid);
+        return false;
+    }
+    if (--entries_[pos].count > 0) {
+        return false;
+    }
+    Erase(pos);
+    if (!Find(uid, PID_AGGREGATE, resource, pos)) {
+        return false;
+    }
+    if (--entries_[pos].count > 0) {
+        return false;
+    }
+    Erase(pos);
+    return true;
+}
+
+bool StatsActivationTable::DeactivateUid(int32_t uid, uint32_t resource)
+{
+    size_t pos = 0;
+    if (!Find(uid, PID_AGGREGATE, resource, pos)) {
+        STATS_HILOGD(COMP_SVC, "No live holder of uid: %{public}d", uid);
+        return false;
+    }
+    Erase(pos);
+    // Erasing shifts entries back, so look at the same position again after every erase
+    for (size_t i = 0; i < entries_.size();) {
+        const Entry& entry = entries_[i];
+        if (entry.count != 0 && entry.uid == uid && entry.resource == resource) {
+            Erase(i);
+        } else {
+            i++;
+        }
+    }
+    return true;
+}
+
+uint32_t StatsActivationTable::GetHolderCount(int32_t uid, uint32_t resource)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t pos = 0;
+    return Find(uid, PID_AGGREGATE, resource, pos) ? entries_[pos].count : 0;
+}
+
+uint32_t StatsActivationTable::GetDepth(int32_t uid, int32_t pid, uint32_t resource)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t pos = 0;
+    return Find(uid, pid, resource, pos) ? entries_[pos].count : 0;
+}
+
+size_t StatsActivationTable::GetEntryCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entryCount_;
+}
+
+size_t StatsActivationTable::GetCapacity()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void StatsActivationTable::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.assign(INITIAL_CAPACITY, Entry {0, 0, 0, 0});
+    entryCount_ = 0;
+}
+} // namespace PowerMgr
+} // namespace OHOS
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_arena.h"
+
+namespace OHOS {
+namespace PowerMgr {
+std::shared_ptr<StatsHelper::ActiveTimer> StatsArena::AllocateTimer()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timerPool_.Allocate();
+}
+
+std::shared_ptr<StatsHelper::Counter> StatsArena::AllocateCounter()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counterPool_.Allocate();
+}
+
+size_t StatsArena::GetTimerCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timerPool_.GetCount();
+}
+
+size_t StatsArena::GetCounterCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counterPool_.GetCount();
+}
+
+size_t StatsArena::GetArenaBytes()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timerPool_.GetBytes() + counterPool_.GetBytes();
+}
+} // namespace PowerMgr
+} // namespace OHOS
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_cpu_sampler.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "stats_helper.h"
+#include "stats_log.h"
+#include "string_ex.h"
+
+namespace OHOS {
+namespace PowerMgr {
+namespace {
+static const std::string TRIGGER_NAMES[] = { "periodic", "battery", "screen", "compute" };
+}
+
+StatsCpuSampler::~StatsCpuSampler()
+{
+    Stop();
+}
+
+void StatsCpuSampler::Start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isRunning_) {
+        return;
+    }
+    isRunning_ = true;
+    worker_ = std::thread([this] { Run(); });
+}
+
+void StatsCpuSampler::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!isRunning_) {
+            return;
+        }
+        isRunning_ = false;
+    }
+    requestCond_.notify_all();
+    doneCond_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void StatsCpuSampler::SetOnBattery(bool isOnBattery)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isOnBattery_ == isOnBattery) {
+        return;
+    }
+    // The transition itself is sampled by the caller before the switch, the worker only restarts its period
+    isOnBattery_ = isOnBattery;
+    isIntervalChanged_ = true;
+    requestCond_.notify_all();
+}
+
+void StatsCpuSampler::SetScreenOn(bool isScreenOn)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isScreenOn_ == isScreenOn) {
+        return;
+    }
+    isScreenOn_ = isScreenOn;
+    pendingTrigger_ = TRIGGER_SCREEN;
+    requestedSeq_++;
+    requestCond_.notify_all();
+}
+
+void StatsCpuSampler::RequestSample(Trigger trigger)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pendingTrigger_ = trigger;
+    requestedSeq_++;
+    requestCond_.notify_all();
+}
+
+bool StatsCpuSampler::SampleNow(Trigger trigger, int64_t minAgeMs)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (minAgeMs > StatsUtils::DEFAULT_VALUE && lastSampleTimeMs_ > StatsUtils::INVALID_VALUE &&
+        StatsHelper::GetUpTimeMs() - lastSampleTimeMs_ < minAgeMs) {
+        rateLimitedCount_++;
+        return false;
+    }
+    if (minAgeMs > StatsUtils::DEFAULT_VALUE && (isSampling_ || requestedSeq_ > completedSeq_)) {
+        // A sample is already on its way, the caller goes on with the last one instead of waiting for it
+        inFlightSkippedCount_++;
+        return false;
+    }
+    if (!isRunning_) {
+        // Without the worker, e.g. before start, the sample is taken on the calling thread
+        Sample(lock, trigger);
+        return true;
+    }
+    pendingTrigger_ = trigger;
+    uint64_t seq = ++requestedSeq_;
+    requestCond_.notify_all();
+    bool isDone = doneCond_.wait_for(lock, std::chrono::milliseconds(SAMPLE_WAIT_MS),
+        [this, seq] { return completedSeq_ >= seq || !isRunning_; });
+    if (!isDone || completedSeq_ < seq) {
+        STATS_HILOGW(COMP_SVC, "Wait for cpu sample timed out, trigger: %{public}s", TRIGGER_NAMES[trigger].c_str());
+        return false;
+    }
+    return true;
+}
+
+void StatsCpuSampler::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (isRunning_) {
+        // wait_for runs on the steady clock, which does not advance in suspend
+        requestCond_.wait_for(lock, std::chrono::milliseconds(GetIntervalMsLocked()),
+            [this] { return !isRunning_ || isIntervalChanged_ || requestedSeq_ > completedSeq_; });
+        if (!isRunning_) {
+            break;
+        }
+        if (requestedSeq_ > completedSeq_) {
+            Sample(lock, pendingTrigger_);
+        } else if (!isIntervalChanged_) {
+            Sample(lock, TRIGGER_PERIODIC);
+        }
+        isIntervalChanged_ = false;
+    }
+}
+
+void StatsCpuSampler::Sample(std::unique_lock<std::mutex>& lock, Trigger trigger)
+{
+    // Samples run one at a time, the fallback on a calling thread waits for the worker to finish its own
+    doneCond_.wait(lock, [this] { return !isSampling_; });
+    isSampling_ = true;
+    uint64_t seq = requestedSeq_;
+    lock.unlock();
+    auto begin = std::chrono::steady_clock::now();
+    if (callback_) {
+        callback_();
+    }
+    int64_t costUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    int64_t nowMs = StatsHelper::GetUpTimeMs();
+    lock.lock();
+    isSampling_ = false;
+    sampleCounts_[trigger]++;
+    if (lastSampleTimeMs_ > StatsUtils::INVALID_VALUE) {
+        lastIntervalMs_ = nowMs - lastSampleTimeMs_;
+    }
+    lastSampleTimeMs_ = nowMs;
+    lastCostUs_ = costUs;
+    maxCostUs_ = std::max(maxCostUs_, costUs);
+    totalCostUs_ += costUs;
+    completedSeq_ = std::max(completedSeq_, seq);
+    doneCond_.notify_all();
+}
+
+int64_t StatsCpuSampler::GetIntervalMsLocked() const
+{
+    return isOnBattery_ && isScreenOn_ ? ACTIVE_INTERVAL_MS : IDLE_INTERVAL_MS;
+}
+
+int64_t StatsCpuSampler::GetIntervalMs()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return GetIntervalMsLocked();
+}
+
+uint64_t StatsCpuSampler::GetSampleCount(Trigger trigger)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return trigger < TRIGGER_COUNT ? sampleCounts_[trigger] : 0;
+}
+
+void StatsCpuSampler::DumpInfo(std::string& result)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t totalCount = 0;
+    result.append("Cpu sampler dump:\n")
+        .append("Interval: ")
+        .append(ToString(GetIntervalMsLocked()))
+        .append("ms, last interval: ")
+        .append(ToString(lastIntervalMs_))
+        .append("ms\nSamples:");
+    for (uint32_t i = 0; i < TRIGGER_COUNT; i++) {
+        totalCount += sampleCounts_[i];
+        result.append(" ")
+            .append(TRIGGER_NAMES[i])
+            .append("=")
+            .append(ToString(sampleCounts_[i]));
+    }
+    int64_t averageCostUs = totalCount > 0 ? totalCostUs_ / static_cast<int64_t>(totalCount) : 0;
+    result.append(", rate limited=")
+        .append(ToString(rateLimitedCount_))
+        .append(", in flight skipped=")
+        .append(ToString(inFlightSkippedCount_))
+        .append("\nCost: last ")
+        .append(ToString(lastCostUs_))
+        .append("us, average ")
+        .append(ToString(averageCostUs))
+        .append("us, max ")
+        .append(ToString(maxCostUs_))
+        .append("us\n");
+}
+} // namespace PowerMgr
+} // namespace OHOS
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_history.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <limits>
+
+#include "stats_log.h"
+#include "stats_uid_interner.h"
+#include "string_ex.h"
+
+namespace OHOS {
+namespace PowerMgr {
+namespace {
+constexpr double UAH_PER_MAH = 1000.0;
+constexpr int64_t MS_PER_HOUR = 60 * 60 * 1000;
+constexpr int64_t MS_PER_DAY = 24 * MS_PER_HOUR;
+}
+
+bool StatsHistory::GetPartIndex(BatteryStatsInfo::ConsumptionType type, int32_t& index)
+{
+    if (type <= BatteryStatsInfo::CONSUMPTION_TYPE_INVALID || type > BatteryStatsInfo::CONSUMPTION_TYPE_ALARM) {
+        return false;
+    }
+    index = type - BatteryStatsInfo::CONSUMPTION_TYPE_INVALID - 1;
+    return true;
+}
+
+int64_t StatsHistory::TakeDeltaUah(int64_t& lastUah, double cumulativeMah)
+{
+    // A drop of the cumulative value means the stats were reset, nothing was consumed in between
+    int64_t cumulativeUah = std::llround(cumulativeMah * UAH_PER_MAH);
+    int64_t deltaUah = cumulativeUah - lastUah;
+    lastUah = cumulativeUah;
+    return deltaUah;
+}
+
+void StatsHistory::AdvanceTo(int64_t epoch)
+{
+    if (currentEpoch_ != StatsUtils::INVALID_VALUE && epoch <= currentEpoch_) {
+        return;
+    }
+    // Buckets are recycled in place, so every bucket between the last recorded one and the new one is cleared
+    int64_t first = (currentEpoch_ == StatsUtils::INVALID_VALUE) ? epoch : currentEpoch_ + 1;
+    first = std::max(first, epoch - BUCKET_COUNT + 1);
+    for (int64_t i = first; i <= epoch; i++) {
+        int64_t slot = i % BUCKET_COUNT;
+        for (auto& row : partRows_) {
+            row[slot] = 0;
+        }
+        for (auto& row : appRows_) {
+            if (row != nullptr) {
+                (*row)[slot] = 0;
+            }
+        }
+    }
+    currentEpoch_ = epoch;
+}
+
+void StatsHistory::AddToBucket(BucketRow& row, int64_t deltaUah)
+{
+    auto& bucket = row[currentEpoch_ % BUCKET_COUNT];
+    int64_t sum = static_cast<int64_t>(bucket) + deltaUah;
+    bucket = static_cast<int32_t>(std::min(sum, static_cast<int64_t>(std::numeric_limits<int32_t>::max())));
+}
+
+double StatsHistory::SumRow(const BucketRow& row, int64_t beginTimeMs, int64_t endTimeMs) const
+{
+    if (currentEpoch_ == StatsUtils::INVALID_VALUE || endTimeMs < beginTimeMs) {
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    // Buckets are the resolution, a range touching a bucket takes the whole bucket
+    int64_t first = std::max({ beginTimeMs / BUCKET_DURATION_MS, currentEpoch_ - BUCKET_COUNT + 1,
+        static_cast<int64_t>(0) });
+    int64_t last = std::min(endTimeMs / BUCKET_DURATION_MS, currentEpoch_);
+    int64_t sumUah = 0;
+    for (int64_t i = first; i <= last; i++) {
+        sumUah += row[i % BUCKET_COUNT];
+    }
+    return static_cast<double>(sumUah) / UAH_PER_MAH;
+}
+
+void StatsHistory::Record(int64_t timeMs, const StatsResultTable& results)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    AdvanceTo(timeMs / BUCKET_DURATION_MS);
+    double partMah[PART_COUNT] = {};
+    auto& interner = StatsUidInterner::GetInstance();
+    for (const auto& record : results) {
+        int32_t partIndex = 0;
+        if (!GetPartIndex(record.type, partIndex)) {
+            continue;
+        }
+        partMah[partIndex] += record.powerMah;
+        uint32_t uidIndex = 0;
+        if (record.type != BatteryStatsInfo::CONSUMPTION_TYPE_APP || !interner.Find(record.uid, uidIndex)) {
+            continue;
+        }
+        if (uidIndex >= appRows_.size()) {
+            appRows_.resize(uidIndex + 1);
+            lastAppUah_.resize(uidIndex + 1, 0);
+        }
+        int64_t deltaUah = TakeDeltaUah(lastAppUah_[uidIndex], record.powerMah);
+        if (deltaUah <= 0) {
+            continue;
+        }
+        auto& row = appRows_[uidIndex];
+        if (row == nullptr) {
+            row = std::make_unique<BucketRow>();
+            row->fill(0);
+        }
+        AddToBucket(*row, deltaUah);
+    }
+    for (int32_t i = 0; i < PART_COUNT; i++) {
+        int64_t deltaUah = TakeDeltaUah(lastPartUah_[i], partMah[i]);
+        if (deltaUah > 0) {
+            AddToBucket(partRows_[i], deltaUah);
+        }
+    }
+}
+
+bool StatsHistory::IsBucketDue(int64_t timeMs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return currentEpoch_ != StatsUtils::INVALID_VALUE && timeMs / BUCKET_DURATION_MS > currentEpoch_;
+}
+
+double StatsHistory::GetPartPowerMah(BatteryStatsInfo::ConsumptionType type, int64_t beginTimeMs,
+    int64_t endTimeMs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    int32_t partIndex = 0;
+    if (!GetPartIndex(type, partIndex)) {
+        STATS_HILOGW(COMP_SVC, "Invalid consumption type: %{public}d for history", type);
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    return SumRow(partRows_[partIndex], beginTimeMs, endTimeMs);
+}
+
+double StatsHistory::GetAppPowerMah(int32_t uid, int64_t beginTimeMs, int64_t endTimeMs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t uidIndex = 0;
+    if (!StatsUidInterner::GetInstance().Find(uid, uidIndex) || uidIndex >= appRows_.size() ||
+        appRows_[uidIndex] == nullptr) {
+        STATS_HILOGD(COMP_SVC, "No history for uid: %{public}d, return 0", uid);
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    return SumRow(*appRows_[uidIndex], beginTimeMs, endTimeMs);
+}
+
+void StatsHistory::ResetBaseline()
+{
+    // The buckets are kept, a reset of the totals must not erase what was drained before it
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fill(std::begin(lastPartUah_), std::end(lastPartUah_), 0);
+    std::fill(lastAppUah_.begin(), lastAppUah_.end(), 0);
+}
+
+size_t StatsHistory::GetAppRowCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count_if(appRows_.begin(), appRows_.end(),
+        [](const std::unique_ptr<BucketRow>& row) { return row != nullptr; }));
+}
+
+size_t StatsHistory::GetHistoryBytes()
+{
+    size_t appRowCount = GetAppRowCount();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sizeof(partRows_) + appRowCount * sizeof(BucketRow) +
+        appRows_.capacity() * sizeof(std::unique_ptr<BucketRow>) + lastAppUah_.capacity() * sizeof(int64_t);
+}
+
+void StatsHistory::DumpInfo(std::string& result, int64_t timeMs)
+{
+    size_t appRowCount = GetAppRowCount();
+    size_t historyBytes = GetHistoryBytes();
+    result.append("Stats history dump:\n")
+        .append("Bucket duration: ")
+        .append(ToString(BUCKET_DURATION_MS))
+        .append("ms, bucket count: ")
+        .append(ToString(BUCKET_COUNT))
+        .append(", app rows: ")
+        .append(ToString(appRowCount))
+        .append(", history bytes: ")
+        .append(ToString(historyBytes))
+        .append("\n");
+    for (int32_t i = BatteryStatsInfo::CONSUMPTION_TYPE_INVALID + 1; i <= BatteryStatsInfo::CONSUMPTION_TYPE_ALARM;
+        i++) {
+        auto type = static_cast<BatteryStatsInfo::ConsumptionType>(i);
+        double dayMah = GetPartPowerMah(type, timeMs - MS_PER_DAY, timeMs);
+        if (dayMah <= StatsUtils::DEFAULT_VALUE) {
+            continue;
+        }
+        result.append(BatteryStatsInfo::ConvertConsumptionType(type))
+            .append(": last hour ")
+            .append(ToString(GetPartPowerMah(type, timeMs - MS_PER_HOUR, timeMs)))
+            .append("mAh, last day ")
+            .append(ToString(dayMah))
+            .append("mAh\n");
+    }
+    for (int32_t uid : StatsUidInterner::GetInstance().GetUids()) {
+        double dayMah = GetAppPowerMah(uid, timeMs - MS_PER_DAY, timeMs);
+        if (dayMah <= StatsUtils::DEFAULT_VALUE) {
+            continue;
+        }
+        result.append("Uid ")
+            .append(ToString(uid))
+            .append(": last hour ")
+            .append(ToString(GetAppPowerMah(uid, timeMs - MS_PER_HOUR, timeMs)))
+            .append("mAh, last day ")
+            .append(ToString(dayMah))
+            .append("mAh\n");
+    }
+}
+} // namespace PowerMgr
+} // namespace OHOS
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_ledger.h"
+
+#include <algorithm>
+
+#include "stats_log.h"
+#include "stats_uid_interner.h"
+#include "string_ex.h"
+
+namespace OHOS {
+namespace PowerMgr {
+namespace {
+constexpr size_t PART_COUNT = BatteryStatsInfo::CONSUMPTION_TYPE_ALARM - BatteryStatsInfo::CONSUMPTION_TYPE_INVALID;
+}
+
+bool StatsLedger::GetPartIndex(BatteryStatsInfo::ConsumptionType type, int32_t& index)
+{
+    if (type <= BatteryStatsInfo::CONSUMPTION_TYPE_INVALID || type > BatteryStatsInfo::CONSUMPTION_TYPE_ALARM) {
+        return false;
+    }
+    index = type - BatteryStatsInfo::CONSUMPTION_TYPE_INVALID - 1;
+    return true;
+}
+
+bool StatsLedger::IsBuiltinLedger(const std::string& name)
+{
+    return name == LEDGER_BOOT || name == LEDGER_RESET || name == LEDGER_UNPLUG;
+}
+
+bool StatsLedger::GetKey(BatteryStatsInfo::ConsumptionType type, int32_t uid, size_t& key)
+{
+    if (type == BatteryStatsInfo::CONSUMPTION_TYPE_APP && uid > StatsUtils::INVALID_VALUE) {
+        uint32_t uidIndex = 0;
+        if (!StatsUidInterner::GetInstance().Find(uid, uidIndex)) {
+            return false;
+        }
+        key = PART_COUNT + uidIndex;
+        return true;
+    }
+    int32_t partIndex = 0;
+    if (!GetPartIndex(type, partIndex)) {
+        return false;
+    }
+    key = static_cast<size_t>(partIndex);
+    return true;
+}
+
+double StatsLedger::GetSinceBootMah(size_t key) const
+{
+    double powerMah = StatsUtils::DEFAULT_VALUE;
+    if (key < currentMah_.size()) {
+        powerMah += currentMah_[key];
+    }
+    if (key < foldedMah_.size()) {
+        powerMah += foldedMah_[key];
+    }
+    return powerMah;
+}
+
+void StatsLedger::CaptureBaseline(const std::string& name)
+{
+    std::vector<double> baseline(std::max(currentMah_.size(), foldedMah_.size()), StatsUtils::DEFAULT_VALUE);
+    for (size_t key = 0; key < baseline.size(); key++) {
+        baseline[key] = GetSinceBootMah(key);
+    }
+    baselines_[name] = std::move(baseline);
+    STATS_HILOGI(COMP_SVC, "Capture baseline of ledger: %{public}s", name.c_str());
+}
+
+void StatsLedger::Record(const StatsResultTable& results)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fill(currentMah_.begin(), currentMah_.end(), StatsUtils::DEFAULT_VALUE);
+    if (currentMah_.size() < PART_COUNT) {
+        currentMah_.resize(PART_COUNT, StatsUtils::DEFAULT_VALUE);
+    }
+    auto& interner = StatsUidInterner::GetInstance();
+    for (const auto& record : results) {
+        int32_t partIndex = 0;
+        if (!GetPartIndex(record.type, partIndex)) {
+            continue;
+        }
+        currentMah_[partIndex] += record.powerMah;
+        uint32_t uidIndex = 0;
+        if (record.type != BatteryStatsInfo::CONSUMPTION_TYPE_APP || !interner.Find(record.uid, uidIndex)) {
+            continue;
+        }
+        size_t key = PART_COUNT + uidIndex;
+        if (key >= currentMah_.size()) {
+            currentMah_.resize(key + 1, StatsUtils::DEFAULT_VALUE);
+        }
+        currentMah_[key] = record.powerMah;
+    }
+}
+
+void StatsLedger::FoldOnReset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (foldedMah_.size() < currentMah_.size()) {
+        foldedMah_.resize(currentMah_.size(), StatsUtils::DEFAULT_VALUE);
+    }
+    for (size_t key = 0; key < currentMah_.size(); key++) {
+        foldedMah_[key] += currentMah_[key];
+    }
+    std::fill(currentMah_.begin(), currentMah_.end(), StatsUtils::DEFAULT_VALUE);
+    CaptureBaseline(LEDGER_RESET);
+}
+
+bool StatsLedger::Mark(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (name.empty() || name == LEDGER_BOOT || name == LEDGER_RESET) {
+        STATS_HILOGW(COMP_SVC, "Ledger: %{public}s can't be marked", name.c_str());
+        return false;
+    }
+    if (!IsBuiltinLedger(name) && baselines_.find(name) == baselines_.end()) {
+        size_t customCount = static_cast<size_t>(std::count_if(baselines_.begin(), baselines_.end(),
+            [](const auto& iter) { return !IsBuiltinLedger(iter.first); }));
+        if (customCount >= MAX_CUSTOM_LEDGERS) {
+            STATS_HILOGW(COMP_SVC, "Too many custom ledgers, ignore: %{public}s", name.c_str());
+            return false;
+        }
+    }
+    CaptureBaseline(name);
+    return true;
+}
+
+bool StatsLedger::GetPowerMah(const std::string& name, BatteryStatsInfo::ConsumptionType type, int32_t uid,
+    double& powerMah)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t key = 0;
+    if (!GetKey(type, uid, key)) {
+        STATS_HILOGD(COMP_SVC, "No ledger key for type: %{public}d, uid: %{public}d", type, uid);
+        return false;
+    }
+    powerMah = GetSinceBootMah(key);
+    if (name == LEDGER_BOOT) {
+        return true;
+    }
+    auto iter = baselines_.find(name);
+    if (iter == baselines_.end()) {
+        STATS_HILOGD(COMP_SVC, "Ledger: %{public}s is not marked", name.c_str());
+        return false;
+    }
+    // Uids seen after the marker have no baseline, all of their power falls into the window
+    if (key < iter->second.size()) {
+        powerMah -= iter->second[key];
+    }
+    return true;
+}
+
+void StatsLedger::DumpInfo(std::string& result)
+{
+    std::vector<std::string> names = { LEDGER_BOOT };
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& iter : baselines_) {
+            names.push_back(iter.first);
+        }
+    }
+    result.append("Stats ledger dump:\n");
+    for (const auto& name : names) {
+        result.append("Ledger ")
+            .append(name)
+            .append(":");
+        for (int32_t i = BatteryStatsInfo::CONSUMPTION_TYPE_INVALID + 1;
+            i <= BatteryStatsInfo::CONSUMPTION_TYPE_ALARM; i++) {
+            auto type = static_cast<BatteryStatsInfo::ConsumptionType>(i);
+            double powerMah = StatsUtils::DEFAULT_VALUE;
+            if (!GetPowerMah(name, type, StatsUtils::INVALID_VALUE, powerMah) ||
+                powerMah <= StatsUtils::DEFAULT_VALUE) {
+                continue;
+            }
+            result.append(" ")
+                .append(BatteryStatsInfo::ConvertConsumptionType(type))
+                .append(" ")
+                .append(ToString(powerMah))
+                .append("mAh");
+        }
+        result.append("\n");
+    }
+}
+} // namespace PowerMgr
+} // namespace OHOS
@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_timer_store.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+#include "stats_log.h"
+#include "stats_uid_interner.h"
+
+namespace OHOS {
+namespace PowerMgr {
+class StatsTimerStore::TimerView : public StatsHelper::ActiveTimer {
+public:
+    TimerView(StatsTimerStore* store, TimerKind kind, int32_t uid) : store_(store), kind_(kind), uid_(uid) {}
+    ~TimerView() override = default;
+    bool StartRunning() override
+    {
+        return store_->StartRunning(kind_, uid_);
+    }
+
+    bool StopRunning() override
+    {
+        return store_->StopRunning(kind_, uid_);
+    }
+
+    int64_t GetRunningTimeMs() override
+    {
+        return store_->GetRunningTimeMs(kind_, uid_);
+    }
+
+    void AddRunningTimeMs(int64_t avtiveTime) override
+    {
+        store_->AddRunningTimeMs(kind_, uid_, avtiveTime);
+    }
+
+    void Reset() override
+    {
+        store_->Reset(kind_, uid_);
+    }
+private:
+    StatsTimerStore* store_;
+    TimerKind kind_;
+    int32_t uid_;
+};
+
+bool StatsTimerStore::GetTimerKind(StatsUtils::StatsType statsType, TimerKind& kind)
+{
+    switch (statsType) {
+        case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN:
+            kind = TIMER_KIND_BLUETOOTH_BR_SCAN;
+            break;
+        case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN:
+            kind = TIMER_KIND_BLUETOOTH_BLE_SCAN;
+            break;
+        case StatsUtils::STATS_TYPE_CAMERA_ON:
+            kind = TIMER_KIND_CAMERA_ON;
+            break;
+        case StatsUtils::STATS_TYPE_FLASHLIGHT_ON:
+            kind = TIMER_KIND_FLASHLIGHT_ON;
+            break;
+        case StatsUtils::STATS_TYPE_GNSS_ON:
+            kind = TIMER_KIND_GNSS_ON;
+            break;
+        case StatsUtils::STATS_TYPE_SENSOR_GRAVITY_ON:
+            kind = TIMER_KIND_SENSOR_GRAVITY_ON;
+            break;
+        case StatsUtils::STATS_TYPE_SENSOR_PROXIMITY_ON:
+            kind = TIMER_KIND_SENSOR_PROXIMITY_ON;
+            break;
+        case StatsUtils::STATS_TYPE_AUDIO_ON:
+            kind = TIMER_KIND_AUDIO_ON;
+            break;
+        case StatsUtils::STATS_TYPE_WAKELOCK_HOLD:
+            kind = TIMER_KIND_WAKELOCK_HOLD;
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+bool StatsTimerStore::IsSharedKind(TimerKind kind)
+{
+    switch (kind) {
+        case TIMER_KIND_BLUETOOTH_BR_SCAN:
+        case TIMER_KIND_BLUETOOTH_BLE_SCAN:
+        case TIMER_KIND_GNSS_ON:
+        case TIMER_KIND_SENSOR_GRAVITY_ON:
+        case TIMER_KIND_SENSOR_PROXIMITY_ON:
+        case TIMER_KIND_AUDIO_ON:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void StatsTimerStore::SetAccountingMode(AccountingMode mode)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Both times are always kept, switching only changes which one is reported
+    accountingMode_ = mode;
+    STATS_HILOGI(COMP_SVC, "Set accounting mode: %{public}u", mode);
+}
+
+StatsTimerStore::AccountingMode StatsTimerStore::GetAccountingMode()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return accountingMode_;
+}
+
+void StatsTimerStore::AdvanceShareClock(TimerColumn& column, int64_t nowMs)
+{
+    if (column.runningCount > 0 && nowMs > column.shareClockTimeMs) {
+        column.shareClock += static_cast<double>(nowMs - column.shareClockTimeMs) / column.runningCount;
+    }
+    column.shareClockTimeMs = nowMs;
+}
+
+void StatsTimerStore::FoldSharedTime(TimerColumn& column, uint32_t slot)
+{
+    column.sharedTimeMs[slot] += column.shareClock - column.shareStart[slot];
+    column.shareStart[slot] = column.shareClock;
+}
+
+int64_t StatsTimerStore::GetSharedTimeMs(TimerKind kind, int32_t uid)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t slot = 0;
+    if (!FindSlot(uid, slot)) {
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    auto& column = columns_[kind];
+    if (column.isRunning[slot]) {
+        AdvanceShareClock(column, StatsHelper::GetOnBatteryBootTimeMs());
+        FoldSharedTime(column, slot);
+    }
+    return static_cast<int64_t>(column.sharedTimeMs[slot]);
+}
+
+uint32_t StatsTimerStore::GetOrCreateSlot(int32_t uid)
+{
+    uint32_t slot = StatsUidInterner::GetInstance().Intern(uid);
+    if (slot < slotCount_) {
+        return slot;
+    }
+    // Uids interned by other modules in the meantime get their slots here as well
+    slotCount_ = slot + 1;
+    for (auto& column : columns_) {
+        column.startTimeMs.resize(slotCount_, StatsUtils::DEFAULT_VALUE);
+        column.totalTimeMs.resize(slotCount_, StatsUtils::DEFAULT_VALUE);
+        column.isRunning.resize(slotCount_, 0);
+        column.powerMah.resize(slotCount_, StatsUtils::DEFAULT_VALUE);
+        column.shareStart.resize(slotCount_, 0.0);
+        column.sharedTimeMs.resize(slotCount_, 0.0);
+    }
+    STATS_HILOGD(COMP_SVC, "Create timer slot: %{public}u for uid: %{public}d", slot, uid);
+    return slot;
+}
+
+bool StatsTimerStore::FindSlot(int32_t uid, uint32_t& slot) const
+{
+    return StatsUidInterner::GetInstance().Find(uid, slot) && slot < slotCount_;
+}
+
+bool StatsTimerStore::StartRunning(TimerKind kind, int32_t uid)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t slot = GetOrCreateSlot(uid);
+    auto& column = columns_[kind];
+    if (column.isRunning[slot]) {
+        STATS_HILOGD(COMP_SVC, "Active timer was already started");
+        return false;
+    }
+    int64_t nowMs = StatsHelper::GetOnBatteryBootTimeMs();
+    column.startTimeMs[slot] = nowMs;
+    column.isRunning[slot] = 1;
+    if (IsSharedKind(kind)) {
+        AdvanceShareClock(column, nowMs);
+        column.shareStart[slot] = column.shareClock;
+        column.runningCount++;
+    }
+    STATS_HILOGD(COMP_SVC, "Active timer is started");
+    return true;
+}
+
+bool StatsTimerStore::StopRunning(TimerKind kind, int32_t uid)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t slot = 0;
+    auto& column = columns_[kind];
+    if (!FindSlot(uid, slot) || !column.isRunning[slot]) {
+        STATS_HILOGD(COMP_SVC, "No related active timer is running");
+        return false;
+    }
+    int64_t nowMs = StatsHelper::GetOnBatteryBootTimeMs();
+    column.totalTimeMs[slot] += nowMs - column.startTimeMs[slot];
+    column.isRunning[slot] = 0;
+    if (IsSharedKind(kind)) {
+        AdvanceShareClock(column, nowMs);
+        FoldSharedTime(column, slot);
+        column.runningCount--;
+    }
+    STATS_HILOGD(COMP_SVC, "Active timer is stopped");
+    return true;
+}
+
+int64_t StatsTimerStore::GetRunningTimeMs(TimerKind kind, int32_t uid)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t slot = 0;
+    if (!FindSlot(uid, slot)) {
+        STATS_HILOGD(COMP_SVC, "Didn't find related timer for uid: %{public}d, return 0", uid);
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    auto& column = columns_[kind];
+    if (column.isRunning[slot]) {
+        auto tmpStopTimeMs = StatsHelper::GetOnBatteryBootTimeMs();
+        column.totalTimeMs[slot] += tmpStopTimeMs - column.startTimeMs[slot];
+        column.startTimeMs[slot] = tmpStopTimeMs;
+        if (IsSharedKind(kind)) {
+            AdvanceShareClock(column, tmpStopTimeMs);
+            FoldSharedTime(column, slot);
+        }
+    }
+    if (accountingMode_ == ACCOUNTING_SHARED && IsSharedKind(kind)) {
+        return static_cast<int64_t>(column.sharedTimeMs[slot]);
+    }
+    return column.totalTimeMs[slot];
+}
+
+void StatsTimerStore::AddRunningTimeMs(TimerKind kind, int32_t uid, int64_t activeTimeMs)
+{
+    if (activeTimeMs <= StatsUtils::DEFAULT_VALUE) {
+        STATS_HILOGW(COMP_SVC, "Invalid active time, ignore");
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t slot = GetOrCreateSlot(uid);
+    // Reported durations carry no overlap information, they count in full in both modes
+    columns_[kind].totalTimeMs[slot] += activeTimeMs;
+    columns_[kind].sharedTimeMs[slot] += activeTimeMs;
+    STATS_HILOGD(COMP_SVC, "Add on active Time: %{public}" PRId64 "", activeTimeMs);
+}
+
+void StatsTimerStore::SetPowerMah(TimerKind kind, int32_t uid, double powerMah)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t slot = GetOrCreateSlot(uid);
+    columns_[kind].powerMah[slot] = powerMah;
+}
+
+double StatsTimerStore::GetPowerMah(TimerKind kind, int32_t uid)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t slot = 0;
+    if (!FindSlot(uid, slot)) {
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    return columns_[kind].powerMah[slot];
+}
+
+void StatsTimerStore::GetTotalTimesMs(TimerKind kind, std::vector<int64_t>& totalTimesMs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& column = columns_[kind];
+    int64_t nowMs = StatsHelper::GetOnBatteryBootTimeMs();
+    totalTimesMs.assign(column.totalTimeMs.begin(), column.totalTimeMs.end());
+    for (uint32_t slot = 0; slot < slotCount_; slot++) {
+        if (column.isRunning[slot]) {
+            totalTimesMs[slot] += nowMs - column.startTimeMs[slot];
+        }
+    }
+}
+
+void StatsTimerStore::Reset(TimerKind kind)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& column = columns_[kind];
+    std::fill(column.startTimeMs.begin(), column.startTimeMs.end(), StatsHelper::GetOnBatteryBootTimeMs());
+    std::fill(column.totalTimeMs.begin(), column.totalTimeMs.end(), StatsUtils::DEFAULT_VALUE);
+    std::fill(column.isRunning.begin(), column.isRunning.end(), 0);
+    std::fill(column.powerMah.begin(), column.powerMah.end(), StatsUtils::DEFAULT_VALUE);
+    std::fill(column.shareStart.begin(), column.shareStart.end(), 0.0);
+    std::fill(column.sharedTimeMs.begin(), column.sharedTimeMs.end(), 0.0);
+    column.shareClock = 0.0;
+    column.runningCount = 0;
+    column.shareClockTimeMs = StatsHelper::GetOnBatteryBootTimeMs();
+}
+
+void StatsTimerStore::Reset(TimerKind kind, int32_t uid)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t slot = 0;
+    if (!FindSlot(uid, slot)) {
+        return;
+    }
+    auto& column = columns_[kind];
+    if (column.isRunning[slot] && IsSharedKind(kind)) {
+        // The other holders get the slice up to now split with this one still in
+        AdvanceShareClock(column, StatsHelper::GetOnBatteryBootTimeMs());
+        column.runningCount--;
+    }
+    column.startTimeMs[slot] = StatsHelper::GetOnBatteryBootTimeMs();
+    column.totalTimeMs[slot] = StatsUtils::DEFAULT_VALUE;
+    column.isRunning[slot] = 0;
+    column.powerMah[slot] = StatsUtils::DEFAULT_VALUE;
+    column.shareStart[slot] = 0.0;
+    column.sharedTimeMs[slot] = 0.0;
+}
+
+std::shared_ptr<StatsHelper::ActiveTimer> StatsTimerStore::GetTimer(TimerKind kind, int32_t uid)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t slot = GetOrCreateSlot(uid);
+    auto& views = columns_[kind].views;
+    if (slot >= views.size()) {
+        views.resize(slot + 1);
+    }
+    if (views[slot] == nullptr) {
+        views[slot] = std::make_shared<TimerView>(this, kind, uid);
+    }
+    return views[slot];
+}
+
+size_t StatsTimerStore::GetSlotCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slotCount_;
+}
+
+StatsTimerStore::NamedTimer* StatsTimerStore::FindNamedTimer(uint32_t slot, uint32_t nameId, bool create)
+{
+    if (slot >= namedTimers_.size()) {
+        if (!create) {
+            return nullptr;
+        }
+        namedTimers_.resize(slot + 1);
+    }
+    auto& timers = namedTimers_[slot];
+    NamedTimer* otherTimer = nullptr;
+    for (auto& timer : timers) {
+        if (timer.nameId == nameId) {
+            return &timer;
+        }
+        if (timer.nameId == NAME_ID_OTHER) {
+            otherTimer = &timer;
+        }
+    }
+    // The last entry is kept for the overflow timer
+    if (timers.size() + 1 < MAX_NAMED_TIMERS_PER_UID) {
+        if (!create) {
+            return nullptr;
+        }
+        timers.push_back({nameId, 0, StatsUtils::DEFAULT_VALUE, StatsUtils::DEFAULT_VALUE});
+        return &timers.back();
+    }
+    if (otherTimer == nullptr) {
+        if (!create) {
+            return nullptr;
+        }
+        STATS_HILOGI(COMP_SVC, "Too many named timers for slot: %{public}u, use the other timer", slot);
+        timers.push_back({NAME_ID_OTHER, 0, StatsUtils::DEFAULT_VALUE, StatsUtils::DEFAULT_VALUE});
+        otherTimer = &timers.back();
+    }
+    return otherTimer;
+}
+
+bool StatsTimerStore::StartNamedRunning(int32_t uid, uint32_t nameId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    NamedTimer* timer = FindNamedTimer(GetOrCreateSlot(uid), nameId, true);
+    if (timer->runningCount++ == 0) {
+        timer->startTimeMs = StatsHelper::GetOnBatteryBootTimeMs();
+    }
+    return true;
+}
+
+bool StatsTimerStore::StopNamedRunning(int32_t uid, uint32_t nameId, bool isAllHolders)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t slot = 0;
+    NamedTimer* timer = FindSlot(uid, slot) ? FindNamedTimer(slot, nameId, false) : nullptr;
+    if (timer == nullptr || timer->runningCount == 0) {
+        STATS_HILOGD(COMP_SVC, "No related named timer is running");
+        return false;
+    }
+    timer->runningCount = isAllHolders ? 0 : timer->runningCount - 1;
+    if (timer->runningCount == 0) {
+        timer->totalTimeMs += StatsHelper::GetOnBatteryBootTimeMs() - timer->startTimeMs;
+    }
+    return true;
+}
+
+std::vector<StatsTimerStore::NamedTime> StatsTimerStore::GetNamedTimes()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<NamedTime> namedTimes;
+    int64_t nowMs = StatsHelper::GetOnBatteryBootTimeMs();
+    auto& interner = StatsUidInterner::GetInstance();
+    for (uint32_t slot = 0; slot < namedTimers_.size(); slot++) {
+        for (const auto& timer : namedTimers_[slot]) {
+            int64_t totalTimeMs = timer.totalTimeMs;
+            if (timer.runningCount > 0) {
+                totalTimeMs += nowMs - timer.startTimeMs;
+            }
+            namedTimes.push_back({interner.GetUid(slot), timer.nameId, totalTimeMs});
+        }
+    }
+    return namedTimes;
+}
+
+void StatsTimerStore::ResetNamed()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t nowMs = StatsHelper::GetOnBatteryBootTimeMs();
+    for (auto& timers : namedTimers_) {
+        timers.erase(std::remove_if(timers.begin(), timers.end(),
+            [](const NamedTimer& timer) { return timer.runningCount == 0; }), timers.end());
+        for (auto& timer : timers) {
+            timer.startTimeMs = nowMs;
+            timer.totalTimeMs = StatsUtils::DEFAULT_VALUE;
+        }
+    }
+}
+} // namespace PowerMgr
+} // namespace OHOS
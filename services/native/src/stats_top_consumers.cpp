@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_top_consumers.h"
+
+#include <algorithm>
+
+#include "stats_log.h"
+#include "stats_uid_interner.h"
+
+namespace OHOS {
+namespace PowerMgr {
+namespace {
+constexpr int32_t NOT_IN_HEAP = -1;
+}
+
+void StatsTopConsumers::Swap(size_t first, size_t second)
+{
+    std::swap(heap_[first], heap_[second]);
+    heapPos_[heap_[first].index] = static_cast<int32_t>(first);
+    heapPos_[heap_[second].index] = static_cast<int32_t>(second);
+}
+
+void StatsTopConsumers::SiftUp(size_t pos)
+{
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (heap_[parent].powerMah <= heap_[pos].powerMah) {
+            break;
+        }
+        Swap(parent, pos);
+        pos = parent;
+    }
+}
+
+void StatsTopConsumers::SiftDown(size_t pos)
+{
+    while (true) {
+        size_t smallest = pos;
+        size_t left = pos * 2 + 1;
+        size_t right = left + 1;
+        if (left < heap_.size() && heap_[left].powerMah < heap_[smallest].powerMah) {
+            smallest = left;
+        }
+        if (right < heap_.size() && heap_[right].powerMah < heap_[smallest].powerMah) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            break;
+        }
+        Swap(smallest, pos);
+        pos = smallest;
+    }
+}
+
+void StatsTopConsumers::Update(uint32_t index, double powerMah)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= heapPos_.size()) {
+        heapPos_.resize(index + 1, NOT_IN_HEAP);
+    }
+    int32_t pos = heapPos_[index];
+    if (pos != NOT_IN_HEAP) {
+        double lastPowerMah = heap_[pos].powerMah;
+        heap_[pos].powerMah = powerMah;
+        if (powerMah > lastPowerMah) {
+            SiftDown(static_cast<size_t>(pos));
+        } else {
+            SiftUp(static_cast<size_t>(pos));
+        }
+        return;
+    }
+    if (heap_.size() < static_cast<size_t>(MAX_TOP_CONSUMERS)) {
+        heap_.push_back({index, powerMah});
+        heapPos_[index] = static_cast<int32_t>(heap_.size() - 1);
+        SiftUp(heap_.size() - 1);
+        return;
+    }
+    if (powerMah <= heap_[0].powerMah) {
+        return;
+    }
+    // Replace the smallest of the top consumers
+    heapPos_[heap_[0].index] = NOT_IN_HEAP;
+    heap_[0] = {index, powerMah};
+    heapPos_[index] = 0;
+    SiftDown(0);
+}
+
+std::vector<std::pair<int32_t, double>> StatsTopConsumers::GetTopConsumers(int32_t count)
+{
+    std::vector<HeapEntry> entries;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries = heap_;
+    }
+    size_t topCount = std::min(entries.size(), static_cast<size_t>(std::max(count, 0)));
+    std::partial_sort(entries.begin(), entries.begin() + topCount, entries.end(),
+        [](const HeapEntry& first, const HeapEntry& second) { return first.powerMah > second.powerMah; });
+    std::vector<std::pair<int32_t, double>> topConsumers;
+    topConsumers.reserve(topCount);
+    auto& interner = StatsUidInterner::GetInstance();
+    for (size_t i = 0; i < topCount; i++) {
+        topConsumers.emplace_back(interner.GetUid(entries[i].index), entries[i].powerMah);
+    }
+    STATS_HILOGD(COMP_SVC, "Get %{public}d top consumers", static_cast<int32_t>(topCount));
+    return topConsumers;
+}
+
+void StatsTopConsumers::Reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    heap_.clear();
+    std::fill(heapPos_.begin(), heapPos_.end(), NOT_IN_HEAP);
+}
+
+void StatsTopConsumers::Invalidate()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    heap_.clear();
+    std::fill(heapPos_.begin(), heapPos_.end(), NOT_IN_HEAP);
+    isInvalidated_ = true;
+}
+
+bool StatsTopConsumers::TakeInvalidated()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool isInvalidated = isInvalidated_;
+    isInvalidated_ = false;
+    return isInvalidated;
+}
+} // namespace PowerMgr
+} // namespace OHOS
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_uid_interner.h"
+
+#include <algorithm>
+#include <ohos_account_kits_impl.h>
+
+#include "stats_log.h"
+#include "stats_utils.h"
+
+namespace OHOS {
+namespace PowerMgr {
+StatsUidInterner& StatsUidInterner::GetInstance()
+{
+    static StatsUidInterner instance;
+    return instance;
+}
+
+uint32_t StatsUidInterner::Intern(int32_t uid)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return InternLocked(uid);
+}
+
+void StatsUidInterner::InternBatch(const int32_t* uids, size_t count, uint32_t* indexes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count; i++) {
+        indexes[i] = InternLocked(uids[i]);
+    }
+}
+
+uint32_t StatsUidInterner::InternLocked(int32_t uid)
+{
+    auto iter = uidIndexMap_.find(uid);
+    if (iter != uidIndexMap_.end()) {
+        return iter->second;
+    }
+    uint32_t index = static_cast<uint32_t>(indexUids_.size());
+    indexUids_.push_back(uid);
+    indexUserIds_.push_back(StatsUtils::INVALID_VALUE);
+    uidIndexMap_.insert(std::pair<int32_t, uint32_t>(uid, index));
+    STATS_HILOGD(COMP_SVC, "Intern uid: %{public}d as index: %{public}u", uid, index);
+    return index;
+}
+
+bool StatsUidInterner::Find(int32_t uid, uint32_t& index)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = uidIndexMap_.find(uid);
+    if (iter == uidIndexMap_.end()) {
+        return false;
+    }
+    index = iter->second;
+    return true;
+}
+
+int32_t StatsUidInterner::GetUid(uint32_t index)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= indexUids_.size()) {
+        STATS_HILOGW(COMP_SVC, "Invalid uid index: %{public}u", index);
+        return StatsUtils::INVALID_VALUE;
+    }
+    return indexUids_[index];
+}
+
+uint32_t StatsUidInterner::GetCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<uint32_t>(indexUids_.size());
+}
+
+std::vector<int32_t> StatsUidInterner::GetUids()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return indexUids_;
+}
+
+int32_t StatsUidInterner::GetUserId(int32_t uid)
+{
+    if (uid < 0) {
+        return StatsUtils::INVALID_VALUE;
+    }
+    uint32_t index = 0;
+    {
+        // Uids that are not tracked yet are interned, so every uid is asked from the account service only once
+        std::lock_guard<std::mutex> lock(mutex_);
+        index = InternLocked(uid);
+        if (indexUserIds_[index] != StatsUtils::INVALID_VALUE) {
+            return indexUserIds_[index];
+        }
+    }
+    int32_t userId = AccountSA::OhosAccountKits::GetInstance().GetDeviceAccountIdByUID(uid);
+    std::lock_guard<std::mutex> lock(mutex_);
+    indexUserIds_[index] = userId;
+    STATS_HILOGD(COMP_SVC, "Cache user id: %{public}d for uid: %{public}d", userId, uid);
+    return userId;
+}
+
+void StatsUidInterner::InvalidateUserIds()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fill(indexUserIds_.begin(), indexUserIds_.end(), StatsUtils::INVALID_VALUE);
+    STATS_HILOGI(COMP_SVC, "User ids of all uids are invalidated");
+}
+} // namespace PowerMgr
+} // namespace OHOS
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CPU_PROC_GENERATOR_H
+#define CPU_PROC_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Writes the four uid cpu proc files read by CpuTimeReader under a fake proc root, for consecutive uids with
+ * speedNums[i] frequencies and coresPerCluster cores in cluster i. Every field of every uid holds the same time
+ * in the unit of its file, so writing a smaller time than before simulates a counter reset.
+ */
+class CpuProcGenerator {
+public:
+    CpuProcGenerator(const std::string& procRoot, const std::vector<uint16_t>& speedNums, uint16_t coresPerCluster);
+    ~CpuProcGenerator() = default;
+    static std::vector<uint16_t> GetUniformSpeedNums(uint16_t clusterNum, uint16_t speedNum);
+    bool Write(int32_t firstUid, int32_t uidCount, int64_t time);
+    void Remove();
+
+private:
+    static constexpr int64_t US_PER_MS = 1000;
+    bool WriteFile(const std::string& name, const std::string& content);
+    std::string procRoot_;
+    std::vector<uint16_t> speedNums_;
+    uint16_t coresPerCluster_;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // CPU_PROC_GENERATOR_H
@@ -931,4 +931,26 @@ HWTEST_F(StatsServiceConfigParseTest, StatsServiceConfigParseTest061, TestSize.L
     ASSERT_FALSE(batteryStatsParser.averageVecMap_.empty());
     STATS_HILOGI(LABEL_TEST, "StatsServiceConfigParseTest061 function end!");
 }
+
+HWTEST_F(StatsServiceConfigParseTest, StatsServiceConfigParseTest062, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceConfigParseTest062 function start!");
+    auto parser = BatteryStatsService::GetInstance()->GetBatteryStatsParser();
+    ASSERT_NE(parser, nullptr);
+    const auto& clusterCoefficients = parser->GetCpuClusterCoefficientsMa();
+    const auto& speedCoefficients = parser->GetCpuSpeedCoefficientsMa();
+    ASSERT_EQ(clusterCoefficients.size(), parser->GetClusterNum());
+    EXPECT_EQ(parser->GetCpuActiveCoefficientMa(), parser->GetAveragePowerMa(StatsUtils::CURRENT_CPU_ACTIVE));
+    size_t offset = 0;
+    for (uint16_t i = 0; i < parser->GetClusterNum(); i++) {
+        EXPECT_EQ(clusterCoefficients[i], parser->GetAveragePowerMa(StatsUtils::CURRENT_CPU_CLUSTER, i));
+        std::string speedType = StatsUtils::CURRENT_CPU_SPEED + std::to_string(i);
+        for (uint16_t j = 0; j < parser->GetSpeedNum(i); j++, offset++) {
+            ASSERT_LT(offset, speedCoefficients.size());
+            EXPECT_EQ(speedCoefficients[offset], parser->GetAveragePowerMa(speedType, j));
+        }
+    }
+    EXPECT_EQ(offset, speedCoefficients.size());
+    STATS_HILOGI(LABEL_TEST, "StatsServiceConfigParseTest062 function end!");
+}
 } // namespace
@@ -16,8 +16,25 @@
 #include "stats_service_core_test.h"
 #include "stats_log.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "battery_stats_core.h"
 #include "battery_stats_service.h"
+#include "cpu_proc_generator.h"
+#include "cpu_time_reader.h"
+#include "entities/cpu_entity.h"
+#include "pid_cpu_time_reader.h"
+#include "stats_activation_table.h"
+#include "stats_arena.h"
+#include "stats_cpu_sampler.h"
+#include "stats_ledger.h"
+#include "stats_top_consumers.h"
+#include "stats_uid_interner.h"
 
 using namespace OHOS;
 using namespace OHOS::PowerMgr;
@@ -26,6 +43,72 @@ using namespace testing::ext;
 
 namespace {
 static sptr<BatteryStatsService> g_statsService = nullptr;
+static const std::string TEST_PROC_ROOT = "/data/local/tmp/stats_proc";
+static const std::string TEST_PID_PROC_ROOT = "/data/local/tmp/stats_pid_proc";
+
+void WriteCpuProcFiles(int32_t uid, int64_t freqTime, int64_t userTimeUs, int64_t systemTimeUs)
+{
+    auto parser = BatteryStatsService::GetInstance()->GetBatteryStatsParser();
+    std::string speedTimes;
+    for (uint16_t i = 0; i < parser->GetClusterNum(); i++) {
+        for (uint16_t j = 0; j < parser->GetSpeedNum(i); j++) {
+            speedTimes.append(" ").append(std::to_string(freqTime));
+        }
+    }
+    mkdir(TEST_PROC_ROOT.c_str(), S_IRWXU);
+    mkdir((TEST_PROC_ROOT + "/uid_cputime").c_str(), S_IRWXU);
+    std::ofstream freqFile(TEST_PROC_ROOT + "/uid_time_in_state", std::ios::trunc);
+    freqFile << "uid:" << speedTimes << "\n" << uid << ":" << speedTimes << "\n";
+    std::ofstream timeFile(TEST_PROC_ROOT + "/uid_cputime/show_uid_stat", std::ios::trunc);
+    timeFile << uid << ": " << userTimeUs << " " << systemTimeUs << "\n";
+    // One cpu running the uid for all of its freq time
+    std::ofstream activeFile(TEST_PROC_ROOT + "/uid_concurrent_active_time", std::ios::trunc);
+    activeFile << "cpus: 1\n" << uid << ": " << freqTime << "\n";
+}
+
+CpuProcGenerator GetCpuProcGenerator()
+{
+    // The layout of the device power profile, one core per cluster
+    auto parser = BatteryStatsService::GetInstance()->GetBatteryStatsParser();
+    std::vector<uint16_t> speedNums;
+    for (uint16_t i = 0; i < parser->GetClusterNum(); i++) {
+        speedNums.push_back(parser->GetSpeedNum(i));
+    }
+    return CpuProcGenerator(TEST_PROC_ROOT, speedNums, 1);
+}
+
+// All four cpu proc files for uidCount consecutive uids, every speed and cpu at the same time
+void WriteSyntheticCpuProcFiles(int32_t firstUid, int32_t uidCount, int64_t freqTime)
+{
+    GetCpuProcGenerator().Write(firstUid, uidCount, freqTime);
+}
+
+void RemoveCpuProcFiles()
+{
+    GetCpuProcGenerator().Remove();
+}
+
+// A fake /proc/[pid] holding the stat and status fields the pid reader parses, times in clock ticks
+void WritePidProcFiles(int32_t pid, int32_t uid, int64_t userTicks, int64_t systemTicks, int64_t startTime)
+{
+    std::string pidDir = TEST_PID_PROC_ROOT + "/" + std::to_string(pid);
+    mkdir(TEST_PID_PROC_ROOT.c_str(), S_IRWXU);
+    mkdir(pidDir.c_str(), S_IRWXU);
+    std::ofstream statFile(pidDir + "/stat", std::ios::trunc);
+    statFile << pid << " (test (app)) S 1 1 0 0 -1 4194560 100 0 0 0 " << userTicks << " " << systemTicks <<
+        " 0 0 20 0 1 0 " << startTime << " 1000 100\n";
+    std::ofstream statusFile(pidDir + "/status", std::ios::trunc);
+    statusFile << "Name:\ttest\nState:\tS (sleeping)\nUid:\t" << uid << "\t" << uid << "\t" << uid << "\t" << uid <<
+        "\nGid:\t0\t0\t0\t0\n";
+}
+
+void RemovePidProcFiles(int32_t pid)
+{
+    std::string pidDir = TEST_PID_PROC_ROOT + "/" + std::to_string(pid);
+    std::remove((pidDir + "/stat").c_str());
+    std::remove((pidDir + "/status").c_str());
+    rmdir(pidDir.c_str());
+}
 } // namespace
 
 void StatsServiceCoreTest::SetUpTestCase()
@@ -307,4 +390,1110 @@ HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_007, TestSize.Level0)
     EXPECT_EQ(StatsUtils::DEFAULT_VALUE, uidEntity->GetStatsPowerMah(StatsUtils::STATS_TYPE_INVALID));
     STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_007 end");
 }
+
+/**
+ * @tc.name: StatsServiceCoreTest_008
+ * @tc.desc: test per-uid timers shared through the timer store
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_008, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_008 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    statsService->SetOnBattery(true);
+    int32_t uid = 10003;
+    int64_t timeMs = 100;
+    auto gnssEntity = statsCore->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_GNSS);
+    auto audioEntity = statsCore->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_AUDIO);
+
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_GNSS_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_GNSS_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    int64_t gnssOnTimeMs = gnssEntity->GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_GNSS_ON);
+    EXPECT_GT(gnssOnTimeMs, StatsUtils::DEFAULT_VALUE);
+    EXPECT_EQ(StatsUtils::DEFAULT_VALUE, audioEntity->GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_AUDIO_ON));
+
+    auto timer = gnssEntity->GetOrCreateTimer(uid, StatsUtils::STATS_TYPE_GNSS_ON);
+    ASSERT_NE(nullptr, timer);
+    EXPECT_EQ(timer, gnssEntity->GetOrCreateTimer(uid, StatsUtils::STATS_TYPE_GNSS_ON));
+    timer->AddRunningTimeMs(timeMs);
+    EXPECT_EQ(gnssOnTimeMs + timeMs, gnssEntity->GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_GNSS_ON));
+    EXPECT_TRUE(timer->StartRunning());
+    EXPECT_FALSE(timer->StartRunning());
+    EXPECT_TRUE(timer->StopRunning());
+    EXPECT_FALSE(timer->StopRunning());
+
+    // A single timer reset clears the time of its own uid only and stops it, like the reset of a whole kind
+    auto otherTimer = gnssEntity->GetOrCreateTimer(uid + 1, StatsUtils::STATS_TYPE_GNSS_ON);
+    ASSERT_NE(nullptr, otherTimer);
+    otherTimer->AddRunningTimeMs(timeMs);
+    EXPECT_TRUE(timer->StartRunning());
+    timer->Reset();
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    EXPECT_FALSE(timer->StopRunning());
+    EXPECT_EQ(StatsUtils::DEFAULT_VALUE, gnssEntity->GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_GNSS_ON));
+    EXPECT_EQ(timeMs, gnssEntity->GetActiveTimeMs(uid + 1, StatsUtils::STATS_TYPE_GNSS_ON));
+
+    gnssEntity->Reset();
+    EXPECT_EQ(StatsUtils::DEFAULT_VALUE, gnssEntity->GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_GNSS_ON));
+    EXPECT_GT(BatteryStatsEntity::GetTimerStore().GetSlotCount(), 0);
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_008 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_009
+ * @tc.desc: test screen brightness time kept per level with one running interval
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_009, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_009 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    statsService->SetOnBattery(true);
+    statsCore->Reset();
+    int16_t firstLevel = 60;
+    int16_t secondLevel = 120;
+
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_SCREEN_ON, StatsUtils::STATS_STATE_ACTIVATED);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, StatsUtils::STATS_STATE_ACTIVATED, firstLevel);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, StatsUtils::STATS_STATE_ACTIVATED, secondLevel);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_SCREEN_ON, StatsUtils::STATS_STATE_DEACTIVATED);
+
+    int64_t firstTimeMs = statsCore->GetTotalTimeMs(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, firstLevel);
+    int64_t secondTimeMs = statsCore->GetTotalTimeMs(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, secondLevel);
+    EXPECT_GT(firstTimeMs, StatsUtils::DEFAULT_VALUE);
+    EXPECT_GT(secondTimeMs, StatsUtils::DEFAULT_VALUE);
+    EXPECT_EQ(StatsUtils::DEFAULT_VALUE, statsCore->GetTotalTimeMs(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, 0));
+    auto screenEntity = statsCore->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN);
+    EXPECT_EQ(firstTimeMs + secondTimeMs, screenEntity->GetActiveTimeMs(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS));
+
+    auto timer = screenEntity->GetOrCreateTimer(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, firstLevel);
+    ASSERT_NE(nullptr, timer);
+    EXPECT_FALSE(timer->StopRunning());
+    EXPECT_EQ(firstTimeMs, timer->GetRunningTimeMs());
+    EXPECT_EQ(nullptr, screenEntity->GetOrCreateTimer(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS,
+        StatsUtils::SCREEN_BRIGHTNESS_BIN + 1));
+    EXPECT_EQ(timer, screenEntity->GetOrCreateTimer(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, firstLevel));
+
+    // Resetting one level clears only that level and stops it if it is running
+    timer->Reset();
+    EXPECT_EQ(StatsUtils::DEFAULT_VALUE, timer->GetRunningTimeMs());
+    EXPECT_EQ(secondTimeMs, statsCore->GetTotalTimeMs(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, secondLevel));
+    EXPECT_TRUE(timer->StartRunning());
+    timer->Reset();
+    EXPECT_FALSE(timer->StopRunning());
+
+    statsCore->Reset();
+    EXPECT_EQ(StatsUtils::DEFAULT_VALUE, screenEntity->GetActiveTimeMs(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS));
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_009 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_010
+ * @tc.desc: test uid interning shared by the uid entity and the timer store
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_010, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_010 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    auto& interner = StatsUidInterner::GetInstance();
+    int32_t uid = 20010042;
+    int32_t unknownUid = 20019999;
+
+    auto uidEntity = statsCore->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
+    uidEntity->UpdateUidMap(uid);
+    uint32_t index = 0;
+    EXPECT_TRUE(interner.Find(uid, index));
+    EXPECT_EQ(index, interner.Intern(uid));
+    EXPECT_EQ(uid, interner.GetUid(index));
+    EXPECT_LT(index, interner.GetCount());
+    EXPECT_FALSE(interner.Find(unknownUid, index));
+    EXPECT_EQ(StatsUtils::INVALID_VALUE, interner.GetUid(interner.GetCount()));
+
+    auto uids = uidEntity->GetUids();
+    EXPECT_NE(uids.end(), std::find(uids.begin(), uids.end(), uid));
+    EXPECT_EQ(StatsUtils::DEFAULT_VALUE, uidEntity->GetEntityPowerMah(unknownUid));
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_010 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_011
+ * @tc.desc: test timers and counters handed out by the stats arena
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_011, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_011 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    statsService->SetOnBattery(true);
+    StatsArena arena;
+    const size_t timerCount = 100;
+    int64_t count = 5;
+    std::vector<std::shared_ptr<StatsHelper::ActiveTimer>> timers;
+    for (size_t i = 0; i < timerCount; i++) {
+        timers.push_back(arena.AllocateTimer());
+    }
+    auto counter = arena.AllocateCounter();
+    EXPECT_EQ(timerCount, arena.GetTimerCount());
+    EXPECT_EQ(1u, arena.GetCounterCount());
+    EXPECT_GT(arena.GetArenaBytes(), timerCount * sizeof(StatsHelper::ActiveTimer));
+
+    int64_t timeMs = SERVICE_POWER_CONSUMPTION_DURATION_US / US_PER_MS;
+    timers.back()->AddRunningTimeMs(timeMs);
+    counter->AddCount(count);
+    EXPECT_EQ(count, counter->GetCount());
+    counter->Reset();
+    EXPECT_EQ(StatsUtils::DEFAULT_VALUE, counter->GetCount());
+    EXPECT_EQ(timeMs, timers.back()->GetRunningTimeMs());
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_011 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_012
+ * @tc.desc: test the computed result table and the list built from it
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_012, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_012 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    statsService->SetOnBattery(true);
+    int32_t uid = 10003;
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    statsCore->ComputePower();
+
+    const auto& results = BatteryStatsEntity::GetStatsResults();
+    auto statsInfoList = statsCore->GetBatteryStats();
+    ASSERT_EQ(results.size(), statsInfoList.size());
+    auto iter = statsInfoList.begin();
+    for (const auto& record : results) {
+        EXPECT_EQ(record.type, (*iter)->GetConsumptionType());
+        EXPECT_EQ(record.uid, (*iter)->GetUid());
+        EXPECT_EQ(record.userId, (*iter)->GetUserId());
+        EXPECT_DOUBLE_EQ(record.powerMah, (*iter)->GetPower());
+        iter++;
+    }
+    EXPECT_GT(statsCore->GetAppStatsMah(uid), StatsUtils::DEFAULT_VALUE);
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_012 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_013
+ * @tc.desc: test the cached user id of a uid and the user power kept across repeated calculations
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_013, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_013 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    auto& interner = StatsUidInterner::GetInstance();
+    EXPECT_EQ(100, interner.GetUserId(20000123));
+    EXPECT_EQ(StatsUtils::INVALID_VALUE, interner.GetUserId(StatsUtils::INVALID_VALUE));
+
+    statsService->SetOnBattery(true);
+    int32_t uid = 10003;
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    int32_t userId = interner.GetUserId(uid);
+    auto userEntity = statsCore->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_USER);
+    statsCore->ComputePower();
+    double userPower = userEntity->GetEntityPowerMah(userId);
+    EXPECT_GT(userPower, StatsUtils::DEFAULT_VALUE);
+    statsCore->ComputePower();
+    EXPECT_DOUBLE_EQ(userPower, userEntity->GetEntityPowerMah(userId));
+
+    interner.InvalidateUserIds();
+    EXPECT_EQ(userId, interner.GetUserId(uid));
+    statsCore->ComputePower();
+    EXPECT_DOUBLE_EQ(userPower, userEntity->GetEntityPowerMah(userId));
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_013 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_014
+ * @tc.desc: test the rolling power history of an app and its part
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_014, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_014 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    statsService->SetOnBattery(true);
+    int32_t uid = 10014;
+    int64_t beginTimeMs = StatsHelper::GetBootTimeMs();
+    double partHistoryMah = statsCore->GetHistoryMah(BatteryStatsInfo::CONSUMPTION_TYPE_APP,
+        StatsUtils::INVALID_VALUE, beginTimeMs, beginTimeMs);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    statsCore->ComputePower();
+    int64_t endTimeMs = StatsHelper::GetBootTimeMs();
+
+    double appMah = statsCore->GetAppStatsMah(uid);
+    double appHistoryMah = statsCore->GetHistoryMah(BatteryStatsInfo::CONSUMPTION_TYPE_APP, uid, beginTimeMs,
+        endTimeMs);
+    EXPECT_GT(appHistoryMah, StatsUtils::DEFAULT_VALUE);
+    EXPECT_NEAR(appMah, appHistoryMah, 0.001);
+    EXPECT_GE(statsCore->GetHistoryMah(BatteryStatsInfo::CONSUMPTION_TYPE_APP, StatsUtils::INVALID_VALUE,
+        beginTimeMs, endTimeMs), partHistoryMah + appHistoryMah - 0.001);
+    EXPECT_EQ(StatsUtils::DEFAULT_VALUE, statsCore->GetHistoryMah(BatteryStatsInfo::CONSUMPTION_TYPE_APP, uid,
+        0, endTimeMs - StatsHistory::BUCKET_DURATION_MS * StatsHistory::BUCKET_COUNT));
+
+    // A reset of the totals keeps the history
+    statsCore->Reset();
+    statsCore->ComputePower();
+    EXPECT_NEAR(appHistoryMah, statsCore->GetHistoryMah(BatteryStatsInfo::CONSUMPTION_TYPE_APP, uid, beginTimeMs,
+        StatsHelper::GetBootTimeMs()), 0.001);
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_014 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_015
+ * @tc.desc: test the top consumers kept while app power changes
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_015, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_015 start");
+    auto& interner = StatsUidInterner::GetInstance();
+    StatsTopConsumers topConsumers;
+    int32_t baseUid = 10150;
+    int32_t uidCount = StatsTopConsumers::MAX_TOP_CONSUMERS + 8;
+    for (int32_t i = 0; i < uidCount; i++) {
+        topConsumers.Update(interner.Intern(baseUid + i), static_cast<double>(i + 1));
+    }
+    auto top = topConsumers.GetTopConsumers(3);
+    ASSERT_EQ(3u, top.size());
+    EXPECT_EQ(baseUid + uidCount - 1, top[0].first);
+    EXPECT_EQ(baseUid + uidCount - 2, top[1].first);
+    EXPECT_DOUBLE_EQ(static_cast<double>(uidCount - 2), top[2].second);
+
+    // The smallest app grows past all others
+    topConsumers.Update(interner.Intern(baseUid), static_cast<double>(uidCount + 1));
+    top = topConsumers.GetTopConsumers(1);
+    ASSERT_EQ(1u, top.size());
+    EXPECT_EQ(baseUid, top[0].first);
+    EXPECT_EQ(static_cast<size_t>(StatsTopConsumers::MAX_TOP_CONSUMERS), topConsumers.GetTopConsumers(uidCount).size());
+    topConsumers.Reset();
+    EXPECT_TRUE(topConsumers.GetTopConsumers(3).empty());
+
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    statsService->SetOnBattery(true);
+    int32_t uid = 10015;
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    statsCore->ComputePower();
+    auto statsInfoList = statsCore->GetTopConsumers(1);
+    ASSERT_EQ(1u, statsInfoList.size());
+    EXPECT_EQ(uid, statsInfoList.front()->GetUid());
+    EXPECT_DOUBLE_EQ(statsCore->GetAppStatsMah(uid), statsInfoList.front()->GetPower());
+
+    // Switching the accounting mode rebuilds the heap, also for the uids whose power did not change
+    statsCore->SetAccountingMode(StatsTimerStore::ACCOUNTING_SHARED);
+    statsInfoList = statsCore->GetTopConsumers(1);
+    ASSERT_EQ(1u, statsInfoList.size());
+    EXPECT_EQ(uid, statsInfoList.front()->GetUid());
+    EXPECT_DOUBLE_EQ(statsCore->GetAppStatsMah(uid), statsInfoList.front()->GetPower());
+    statsCore->SetAccountingMode(StatsTimerStore::ACCOUNTING_EXCLUSIVE);
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_015 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_016
+ * @tc.desc: test the accounting windows kept as baselines over the power totals
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_016, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_016 start");
+    int32_t uid = 10016;
+    StatsUidInterner::GetInstance().Intern(uid);
+    StatsLedger ledger;
+    StatsResultTable results = {
+        {BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN, StatsUtils::INVALID_VALUE, StatsUtils::INVALID_VALUE, 10.0},
+        {BatteryStatsInfo::CONSUMPTION_TYPE_APP, uid, StatsUtils::INVALID_VALUE, 4.0},
+    };
+    ledger.Record(results);
+    EXPECT_TRUE(ledger.Mark("custom"));
+    EXPECT_FALSE(ledger.Mark(StatsLedger::LEDGER_BOOT));
+    results[0].powerMah = 15.0;
+    results[1].powerMah = 6.0;
+    ledger.Record(results);
+
+    double powerMah = StatsUtils::DEFAULT_VALUE;
+    EXPECT_TRUE(ledger.GetPowerMah("custom", BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN, StatsUtils::INVALID_VALUE,
+        powerMah));
+    EXPECT_DOUBLE_EQ(5.0, powerMah);
+    EXPECT_TRUE(ledger.GetPowerMah("custom", BatteryStatsInfo::CONSUMPTION_TYPE_APP, uid, powerMah));
+    EXPECT_DOUBLE_EQ(2.0, powerMah);
+    EXPECT_FALSE(ledger.GetPowerMah("unknown", BatteryStatsInfo::CONSUMPTION_TYPE_APP, uid, powerMah));
+
+    // A reset folds the totals in, the windows across it keep counting
+    ledger.FoldOnReset();
+    results[0].powerMah = 1.0;
+    results[1].powerMah = 1.0;
+    ledger.Record(results);
+    EXPECT_TRUE(ledger.GetPowerMah(StatsLedger::LEDGER_BOOT, BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN,
+        StatsUtils::INVALID_VALUE, powerMah));
+    EXPECT_DOUBLE_EQ(16.0, powerMah);
+    EXPECT_TRUE(ledger.GetPowerMah(StatsLedger::LEDGER_RESET, BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN,
+        StatsUtils::INVALID_VALUE, powerMah));
+    EXPECT_DOUBLE_EQ(1.0, powerMah);
+    EXPECT_TRUE(ledger.GetPowerMah("custom", BatteryStatsInfo::CONSUMPTION_TYPE_APP, uid, powerMah));
+    EXPECT_DOUBLE_EQ(3.0, powerMah);
+
+    for (size_t i = 1; i < StatsLedger::MAX_CUSTOM_LEDGERS; i++) {
+        EXPECT_TRUE(ledger.Mark("custom" + std::to_string(i)));
+    }
+    EXPECT_FALSE(ledger.Mark("overflow"));
+    EXPECT_TRUE(ledger.Mark(StatsLedger::LEDGER_UNPLUG));
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_016 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_017
+ * @tc.desc: test the hold time per wakelock name and the cap of names per uid
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_017, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_017 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    statsService->SetOnBattery(true);
+    int32_t uid = 10017;
+    statsCore->UpdateWakelockStats(StatsUtils::STATS_STATE_ACTIVATED, uid, "lockA");
+    statsCore->UpdateWakelockStats(StatsUtils::STATS_STATE_ACTIVATED, uid, "lockB");
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateWakelockStats(StatsUtils::STATS_STATE_DEACTIVATED, uid, "lockB");
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateWakelockStats(StatsUtils::STATS_STATE_DEACTIVATED, uid, "lockA");
+
+    auto topWakelocks = statsCore->GetTopWakelocks(2);
+    ASSERT_EQ(2u, topWakelocks.size());
+    EXPECT_EQ(uid, topWakelocks[0].uid);
+    EXPECT_EQ("lockA", topWakelocks[0].name);
+    EXPECT_EQ("lockB", topWakelocks[1].name);
+    EXPECT_GT(topWakelocks[0].holdTimeMs, topWakelocks[1].holdTimeMs);
+
+    // Names beyond the cap of a uid share its other timer
+    int32_t overflowUid = 10018;
+    size_t nameCount = StatsTimerStore::MAX_NAMED_TIMERS_PER_UID + 4;
+    for (size_t i = 0; i < nameCount; i++) {
+        std::string name = "lock" + std::to_string(i);
+        statsCore->UpdateWakelockStats(StatsUtils::STATS_STATE_ACTIVATED, overflowUid, name);
+        statsCore->UpdateWakelockStats(StatsUtils::STATS_STATE_DEACTIVATED, overflowUid, name);
+    }
+    auto allWakelocks = statsCore->GetTopWakelocks(nameCount * 2);
+    auto overflowCount = std::count_if(allWakelocks.begin(), allWakelocks.end(),
+        [overflowUid](const WakelockHoldTime& wakelock) { return wakelock.uid == overflowUid; });
+    EXPECT_EQ(static_cast<int64_t>(StatsTimerStore::MAX_NAMED_TIMERS_PER_UID), overflowCount);
+    EXPECT_TRUE(std::any_of(allWakelocks.begin(), allWakelocks.end(), [overflowUid](const WakelockHoldTime& wakelock) {
+        return wakelock.uid == overflowUid && wakelock.name == "other";
+    }));
+
+    // A running name is kept across a reset, a stop without a process then ends all its holders at once
+    int32_t holderUid = 10019;
+    int32_t firstPid = 3001;
+    int32_t secondPid = 3002;
+    statsCore->UpdateWakelockStats(StatsUtils::STATS_STATE_ACTIVATED, holderUid, "lockC", firstPid);
+    statsCore->UpdateWakelockStats(StatsUtils::STATS_STATE_ACTIVATED, holderUid, "lockC", secondPid);
+    statsCore->Reset();
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateWakelockStats(StatsUtils::STATS_STATE_DEACTIVATED, holderUid, "lockC");
+    topWakelocks = statsCore->GetTopWakelocks(1);
+    ASSERT_EQ(1u, topWakelocks.size());
+    EXPECT_EQ(holderUid, topWakelocks[0].uid);
+    EXPECT_EQ("lockC", topWakelocks[0].name);
+    int64_t holdTimeMs = topWakelocks[0].holdTimeMs;
+    EXPECT_GT(holdTimeMs, StatsUtils::DEFAULT_VALUE);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    EXPECT_EQ(holdTimeMs, statsCore->GetTopWakelocks(1)[0].holdTimeMs);
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_017 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_018
+ * @tc.desc: test the cpu time withheld from running uids is handed to the wakelock holders, synthetic proc files
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_018, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_018 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    auto parser = statsService->GetBatteryStatsParser();
+    ASSERT_GT(parser->GetClusterNum(), 0);
+    ASSERT_GT(parser->GetSpeedNum(0), 0);
+    int32_t runningUid = 10019;
+    int32_t holderUid = 10020;
+    CpuTimeReader reader;
+    reader.SetProcRoot(TEST_PROC_ROOT);
+
+    // The first sample on charger only sets the baselines
+    statsService->SetOnBattery(false);
+    WriteCpuProcFiles(runningUid, 10, 100000, 200000);
+    reader.UpdateCpuTime();
+    statsService->SetOnBattery(true);
+    statsCore->UpdateWakelockStats(StatsUtils::STATS_STATE_ACTIVATED, holderUid, "holderLock");
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateWakelockStats(StatsUtils::STATS_STATE_DEACTIVATED, holderUid, "holderLock");
+
+    // 100ms per speed and 200ms/400ms of user/system time, half of it goes to the only holder
+    WriteCpuProcFiles(runningUid, 20, 300000, 600000);
+    reader.UpdateCpuTime();
+    EXPECT_EQ(50, reader.GetUidCpuFreqTimeMs(runningUid, 0, 0));
+    EXPECT_EQ(50, reader.GetUidCpuFreqTimeMs(holderUid, 0, 0));
+    std::vector<int64_t> holderTime = reader.GetUidCpuTimeMs(holderUid);
+    ASSERT_EQ(2u, holderTime.size());
+    EXPECT_EQ(100, holderTime[0]);
+    EXPECT_EQ(200, holderTime[1]);
+
+    // Without a holder in the interval the running uid keeps the whole increment
+    WriteCpuProcFiles(runningUid, 30, 500000, 1000000);
+    reader.UpdateCpuTime();
+    EXPECT_EQ(150, reader.GetUidCpuFreqTimeMs(runningUid, 0, 0));
+    EXPECT_EQ(50, reader.GetUidCpuFreqTimeMs(holderUid, 0, 0));
+    std::vector<int64_t> runningTime = reader.GetUidCpuTimeMs(runningUid);
+    ASSERT_EQ(2u, runningTime.size());
+    EXPECT_EQ(200, runningTime[0]);
+    EXPECT_EQ(400, runningTime[1]);
+
+    statsService->SetOnBattery(false);
+    std::remove((TEST_PROC_ROOT + "/uid_time_in_state").c_str());
+    std::remove((TEST_PROC_ROOT + "/uid_cputime/show_uid_stat").c_str());
+    std::remove((TEST_PROC_ROOT + "/uid_concurrent_active_time").c_str());
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_018 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_019
+ * @tc.desc: test shared accounting splits the overlapping gnss time among its holders
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_019, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_019 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    auto& store = BatteryStatsEntity::GetTimerStore();
+    statsService->SetOnBattery(true);
+    int32_t uidA = 10021;
+    int32_t uidB = 10022;
+    int64_t toleranceMs = 5;
+    auto kind = StatsTimerStore::TIMER_KIND_GNSS_ON;
+
+    // A runs alone, then A and B together, then B alone
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_GNSS_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uidA);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_GNSS_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uidB);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_GNSS_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uidA);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_GNSS_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uidB);
+
+    int64_t exclusiveA = store.GetRunningTimeMs(kind, uidA);
+    int64_t exclusiveB = store.GetRunningTimeMs(kind, uidB);
+    int64_t sharedA = store.GetSharedTimeMs(kind, uidA);
+    int64_t sharedB = store.GetSharedTimeMs(kind, uidB);
+    // The shared times add up to the union of both holders, the exclusive ones count the overlap twice
+    int64_t sliceMs = SERVICE_POWER_CONSUMPTION_DURATION_US / US_PER_MS;
+    EXPECT_GE(sharedA + sharedB, sliceMs * 3 - toleranceMs);
+    EXPECT_LE(sharedA + sharedB, exclusiveA + exclusiveB - sliceMs + toleranceMs);
+    EXPECT_NEAR(sharedA, sharedB, toleranceMs * 4);
+    EXPECT_LT(sharedA, exclusiveA);
+
+    statsCore->SetAccountingMode(StatsTimerStore::ACCOUNTING_SHARED);
+    EXPECT_EQ(sharedA, store.GetRunningTimeMs(kind, uidA));
+    statsCore->SetAccountingMode(StatsTimerStore::ACCOUNTING_EXCLUSIVE);
+    EXPECT_EQ(exclusiveA, store.GetRunningTimeMs(kind, uidA));
+
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_019 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_020
+ * @tc.desc: test the gnss timer of a uid runs while any of its processes holds gnss, nested starts included
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_020, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_020 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    auto& store = BatteryStatsEntity::GetTimerStore();
+    statsService->SetOnBattery(true);
+    int32_t uid = 10023;
+    int32_t pidA = 3001;
+    int32_t pidB = 3002;
+    int64_t sliceMs = SERVICE_POWER_CONSUMPTION_DURATION_US / US_PER_MS;
+    auto kind = StatsTimerStore::TIMER_KIND_GNSS_ON;
+    auto type = StatsUtils::STATS_TYPE_GNSS_ON;
+
+    // The stop of process A leaves the timer running for process B
+    statsCore->UpdateStats(type, StatsUtils::STATS_STATE_ACTIVATED, StatsUtils::INVALID_VALUE, uid, "", pidA);
+    statsCore->UpdateStats(type, StatsUtils::STATS_STATE_ACTIVATED, StatsUtils::INVALID_VALUE, uid, "", pidB);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(type, StatsUtils::STATS_STATE_DEACTIVATED, StatsUtils::INVALID_VALUE, uid, "", pidA);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(type, StatsUtils::STATS_STATE_DEACTIVATED, StatsUtils::INVALID_VALUE, uid, "", pidB);
+    int64_t timeMs = store.GetRunningTimeMs(kind, uid);
+    EXPECT_GE(timeMs, sliceMs * 2);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    EXPECT_EQ(timeMs, store.GetRunningTimeMs(kind, uid));
+
+    // A nested start of process A needs two stops, a stop of an unknown process is ignored
+    statsCore->Reset();
+    statsCore->UpdateStats(type, StatsUtils::STATS_STATE_ACTIVATED, StatsUtils::INVALID_VALUE, uid, "", pidA);
+    statsCore->UpdateStats(type, StatsUtils::STATS_STATE_ACTIVATED, StatsUtils::INVALID_VALUE, uid, "", pidA);
+    statsCore->UpdateStats(type, StatsUtils::STATS_STATE_DEACTIVATED, StatsUtils::INVALID_VALUE, uid, "", pidA);
+    statsCore->UpdateStats(type, StatsUtils::STATS_STATE_DEACTIVATED, StatsUtils::INVALID_VALUE, uid, "", pidB);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(type, StatsUtils::STATS_STATE_DEACTIVATED, StatsUtils::INVALID_VALUE, uid, "", pidA);
+    timeMs = store.GetRunningTimeMs(kind, uid);
+    EXPECT_GE(timeMs, sliceMs);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    EXPECT_EQ(timeMs, store.GetRunningTimeMs(kind, uid));
+
+    // A stop without a pid ends every process of the uid
+    statsCore->UpdateStats(type, StatsUtils::STATS_STATE_ACTIVATED, StatsUtils::INVALID_VALUE, uid, "", pidA);
+    statsCore->UpdateStats(type, StatsUtils::STATS_STATE_ACTIVATED, StatsUtils::INVALID_VALUE, uid, "", pidB);
+    statsCore->UpdateStats(type, StatsUtils::STATS_STATE_DEACTIVATED, StatsUtils::INVALID_VALUE, uid);
+    timeMs = store.GetRunningTimeMs(kind, uid);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    EXPECT_EQ(timeMs, store.GetRunningTimeMs(kind, uid));
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_020 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_021
+ * @tc.desc: test the activation table keeps its holder counts through growth and backward-shift deletion
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_021, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_021 start");
+    StatsActivationTable table;
+    uint32_t resource = StatsTimerStore::TIMER_KIND_AUDIO_ON;
+    int32_t uidCount = 200;
+    int32_t pidCount = 3;
+    for (int32_t uid = 0; uid < uidCount; uid++) {
+        for (int32_t pid = 0; pid < pidCount; pid++) {
+            EXPECT_EQ(pid == 0, table.Activate(uid, pid, resource));
+        }
+    }
+    EXPECT_EQ(static_cast<size_t>(uidCount * (pidCount + 1)), table.GetEntryCount());
+    EXPECT_GE(table.GetCapacity(), table.GetEntryCount() * 2);
+
+    // Release the processes in a different order than they started
+    for (int32_t uid = 0; uid < uidCount; uid++) {
+        EXPECT_FALSE(table.Deactivate(uid, 1, resource));
+        EXPECT_FALSE(table.Deactivate(uid, 1, resource));
+        EXPECT_FALSE(table.Deactivate(uid, 0, resource));
+        EXPECT_EQ(1u, table.GetHolderCount(uid, resource));
+    }
+    for (int32_t uid = 0; uid < uidCount; uid++) {
+        EXPECT_EQ(1u, table.GetDepth(uid, pidCount - 1, resource));
+        EXPECT_EQ(0u, table.GetHolderCount(uid, resource + 1));
+        EXPECT_TRUE(table.Deactivate(uid, pidCount - 1, resource));
+    }
+    EXPECT_EQ(0u, table.GetEntryCount());
+    table.Clear();
+    EXPECT_TRUE(table.Activate(1, 1, resource));
+    EXPECT_FALSE(table.Activate(1, 1, resource));
+    EXPECT_EQ(2u, table.GetDepth(1, 1, resource));
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_021 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_022
+ * @tc.desc: test cameras opened by different uids run at the same time, with the flashlight of each device
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_022, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_022 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    auto& store = BatteryStatsEntity::GetTimerStore();
+    statsService->SetOnBattery(true);
+    int32_t uidA = 10024;
+    int32_t uidB = 10025;
+    int64_t sliceMs = SERVICE_POWER_CONSUMPTION_DURATION_US / US_PER_MS;
+    auto cameraKind = StatsTimerStore::TIMER_KIND_CAMERA_ON;
+    auto flashlightKind = StatsTimerStore::TIMER_KIND_FLASHLIGHT_ON;
+
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uidA, "Camera0");
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uidB, "Camera1");
+    // The flashlight of the rear camera only, then the one of the latest camera without a device id
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_FLASHLIGHT_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, StatsUtils::INVALID_VALUE, "Camera0");
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_FLASHLIGHT_ON, StatsUtils::STATS_STATE_ACTIVATED);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, StatsUtils::INVALID_VALUE, "Camera0");
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, StatsUtils::INVALID_VALUE, "Camera1");
+
+    int64_t toleranceMs = 20;
+    EXPECT_NEAR(sliceMs * 2, store.GetRunningTimeMs(cameraKind, uidA), toleranceMs);
+    EXPECT_NEAR(sliceMs * 3, store.GetRunningTimeMs(cameraKind, uidB), toleranceMs);
+    // Closing a camera turns off its own flashlight only
+    EXPECT_NEAR(sliceMs * 2, store.GetRunningTimeMs(flashlightKind, uidA), toleranceMs);
+    EXPECT_NEAR(sliceMs * 2, store.GetRunningTimeMs(flashlightKind, uidB), toleranceMs);
+
+    // Every device has its own session, more devices than slots are ignored
+    for (int32_t i = 0; i < 10; i++) {
+        statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_ACTIVATED,
+            StatsUtils::INVALID_VALUE, uidA, "Virtual" + std::to_string(i));
+    }
+    for (int32_t i = 0; i < 10; i++) {
+        statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+            StatsUtils::INVALID_VALUE, StatsUtils::INVALID_VALUE, "Virtual" + std::to_string(i));
+    }
+    int64_t timeMs = store.GetRunningTimeMs(cameraKind, uidA);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    EXPECT_EQ(timeMs, store.GetRunningTimeMs(cameraKind, uidA));
+
+    // Two cameras of the same uid open at the same time are charged twice
+    timeMs = store.GetRunningTimeMs(cameraKind, uidB);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uidB, "Camera0");
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uidB, "Camera1");
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, StatsUtils::INVALID_VALUE, "Camera0");
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, StatsUtils::INVALID_VALUE, "Camera1");
+    EXPECT_NEAR(timeMs + sliceMs * 3, store.GetRunningTimeMs(cameraKind, uidB), toleranceMs);
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_022 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_024
+ * @tc.desc: test the cpu proc files stay open across samples and their reads show in the dump
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_024, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_024 start");
+    CpuTimeReader reader;
+    reader.SetProcRoot(TEST_PROC_ROOT);
+    WriteSyntheticCpuProcFiles(20000, 10, 10);
+    EXPECT_TRUE(reader.UpdateCpuTime());
+    // Rewriting a file in place is seen through the descriptor kept open
+    WriteSyntheticCpuProcFiles(20000, 20, 20);
+    EXPECT_TRUE(reader.UpdateCpuTime());
+    EXPECT_TRUE(reader.UpdateCpuTime());
+
+    struct stat fileStat {};
+    ASSERT_EQ(0, stat((TEST_PROC_ROOT + "/uid_time_in_state").c_str(), &fileStat));
+    std::string result;
+    reader.DumpReadInfo(result);
+    std::string expected = "uid_time_in_state: size=" + std::to_string(fileStat.st_size) + "B";
+    EXPECT_NE(std::string::npos, result.find(expected));
+    EXPECT_EQ(std::string::npos, result.find("opens=2"));
+    EXPECT_EQ(std::string::npos, result.find("errors=1"));
+
+    RemoveCpuProcFiles();
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_024 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_025
+ * @tc.desc: test the cpu sampler samples on transitions and before computing, and adapts its period
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_025, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_025 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    auto sampler = statsCore->GetCpuSampler();
+    ASSERT_NE(nullptr, sampler);
+    statsService->SetOnBattery(false);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_SCREEN_ON, StatsUtils::STATS_STATE_DEACTIVATED);
+    EXPECT_EQ(StatsCpuSampler::IDLE_INTERVAL_MS, sampler->GetIntervalMs());
+
+    // The battery transition is sampled before it returns
+    uint64_t batteryCount = sampler->GetSampleCount(StatsCpuSampler::TRIGGER_BATTERY);
+    statsService->SetOnBattery(true);
+    EXPECT_EQ(batteryCount + 1, sampler->GetSampleCount(StatsCpuSampler::TRIGGER_BATTERY));
+    statsService->SetOnBattery(true);
+    EXPECT_EQ(batteryCount + 1, sampler->GetSampleCount(StatsCpuSampler::TRIGGER_BATTERY));
+
+    // The screen transition is sampled asynchronously and shortens the period
+    uint64_t screenCount = sampler->GetSampleCount(StatsCpuSampler::TRIGGER_SCREEN);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_SCREEN_ON, StatsUtils::STATS_STATE_ACTIVATED);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    EXPECT_EQ(screenCount + 1, sampler->GetSampleCount(StatsCpuSampler::TRIGGER_SCREEN));
+    EXPECT_EQ(StatsCpuSampler::ACTIVE_INTERVAL_MS, sampler->GetIntervalMs());
+
+    // A compute right after a sample reuses it
+    uint64_t computeCount = sampler->GetSampleCount(StatsCpuSampler::TRIGGER_COMPUTE);
+    statsCore->ComputePower();
+    EXPECT_EQ(computeCount, sampler->GetSampleCount(StatsCpuSampler::TRIGGER_COMPUTE));
+
+    std::string result;
+    sampler->DumpInfo(result);
+    EXPECT_NE(std::string::npos, result.find("Cpu sampler dump"));
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_SCREEN_ON, StatsUtils::STATS_STATE_DEACTIVATED);
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_025 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_026
+ * @tc.desc: test reading the cpu proc files in parallel gives the same times as reading them in sequence
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_026, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_026 start");
+    CpuTimeReader sequentialReader;
+    CpuTimeReader parallelReader;
+    sequentialReader.SetProcRoot(TEST_PROC_ROOT);
+    parallelReader.SetProcRoot(TEST_PROC_ROOT);
+    parallelReader.SetParallelRead(true);
+    WriteSyntheticCpuProcFiles(30000, 100, 10);
+    EXPECT_TRUE(sequentialReader.UpdateCpuTime());
+    EXPECT_TRUE(parallelReader.UpdateCpuTime());
+    WriteSyntheticCpuProcFiles(30000, 100, 30);
+    EXPECT_TRUE(sequentialReader.UpdateCpuTime());
+    EXPECT_TRUE(parallelReader.UpdateCpuTime());
+
+    for (int32_t uid = 30000; uid < 30100; uid++) {
+        EXPECT_EQ(sequentialReader.GetUidCpuActiveTimeMs(uid), parallelReader.GetUidCpuActiveTimeMs(uid));
+        EXPECT_EQ(sequentialReader.GetUidCpuClusterTimeMs(uid, 0), parallelReader.GetUidCpuClusterTimeMs(uid, 0));
+        EXPECT_EQ(sequentialReader.GetUidCpuFreqTimeMs(uid, 0, 0), parallelReader.GetUidCpuFreqTimeMs(uid, 0, 0));
+        EXPECT_EQ(sequentialReader.GetUidCpuTimeMs(uid), parallelReader.GetUidCpuTimeMs(uid));
+    }
+    EXPECT_GT(parallelReader.GetUidCpuFreqTimeMs(30000, 0, 0), 0);
+
+    std::string result;
+    parallelReader.DumpReadInfo(result);
+    EXPECT_NE(std::string::npos, result.find("Cpu proc file reads: parallel"));
+
+    RemoveCpuProcFiles();
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_026 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_027
+ * @tc.desc: test the pid cpu time reader charges only new time, and handles pid reuse and process exit
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_027, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_027 start");
+    int64_t msPerTick = StatsUtils::MS_IN_SECOND / sysconf(_SC_CLK_TCK);
+    PidCpuTimeReader reader;
+    reader.SetProcRoot(TEST_PID_PROC_ROOT);
+    WritePidProcFiles(100, 20010, 10, 5, 1000);
+    WritePidProcFiles(101, 20010, 3, 2, 1001);
+    WritePidProcFiles(102, 20011, 7, 0, 1002);
+    ASSERT_TRUE(reader.Scan());
+    auto increments = reader.GetUidIncrements();
+    EXPECT_EQ(13 * msPerTick, increments[20010].userTimeMs);
+    EXPECT_EQ(7 * msPerTick, increments[20010].systemTimeMs);
+    EXPECT_EQ(7 * msPerTick, increments[20011].userTimeMs);
+
+    // Pid 101 exits, pid 102 is reused by a process of another uid
+    WritePidProcFiles(100, 20010, 20, 5, 1000);
+    RemovePidProcFiles(101);
+    WritePidProcFiles(102, 20012, 4, 1, 2000);
+    ASSERT_TRUE(reader.Scan());
+    increments = reader.GetUidIncrements();
+    EXPECT_EQ(10 * msPerTick, increments[20010].userTimeMs);
+    EXPECT_EQ(0, increments[20010].systemTimeMs);
+    EXPECT_EQ(0u, increments.count(20011));
+    EXPECT_EQ(4 * msPerTick, increments[20012].userTimeMs);
+    EXPECT_EQ(1 * msPerTick, increments[20012].systemTimeMs);
+    EXPECT_EQ(2u, reader.GetPidCount());
+
+    ASSERT_TRUE(reader.Scan());
+    EXPECT_TRUE(reader.GetUidIncrements().empty());
+
+    RemovePidProcFiles(100);
+    RemovePidProcFiles(102);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_027 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_028
+ * @tc.desc: test the cpu time reader falls back to the pid files when the uid cpu files are missing
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_028, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_028 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    int64_t msPerTick = StatsUtils::MS_IN_SECOND / sysconf(_SC_CLK_TCK);
+    statsService->SetOnBattery(true);
+    CpuTimeReader reader;
+    reader.SetProcRoot(TEST_PID_PROC_ROOT);
+    WritePidProcFiles(200, 20020, 10, 5, 1000);
+    EXPECT_TRUE(reader.UpdateCpuTime());
+    EXPECT_EQ(15 * msPerTick, reader.GetUidCpuActiveTimeMs(20020));
+    WritePidProcFiles(200, 20020, 20, 5, 1000);
+    EXPECT_TRUE(reader.UpdateCpuTime());
+    EXPECT_EQ(25 * msPerTick, reader.GetUidCpuActiveTimeMs(20020));
+
+    std::string result;
+    reader.DumpReadInfo(result);
+    EXPECT_NE(std::string::npos, result.find("Pid cpu time fallback: pids=1"));
+
+    RemovePidProcFiles(200);
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_028 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_029
+ * @tc.desc: test the cpu time reader resolves the uids of moved and new rows in one batch
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_029, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_029 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    CpuTimeReader reader;
+    reader.SetProcRoot(TEST_PROC_ROOT);
+    statsService->SetOnBattery(false);
+    WriteSyntheticCpuProcFiles(40000, 100, 10);
+    EXPECT_TRUE(reader.UpdateCpuTime());
+
+    // Half of the uids are gone, the rest moved up by 50 rows and are followed by 50 new uids
+    statsService->SetOnBattery(true);
+    WriteSyntheticCpuProcFiles(40050, 100, 20);
+    EXPECT_TRUE(reader.UpdateCpuTime());
+    std::string result;
+    reader.DumpReadInfo(result);
+    EXPECT_NE(std::string::npos, result.find("new uid rows=400"));
+    EXPECT_EQ(100, reader.GetUidCpuFreqTimeMs(40050, 0, 0));
+    EXPECT_EQ(100, reader.GetUidCpuFreqTimeMs(40099, 0, 0));
+    EXPECT_EQ(200, reader.GetUidCpuFreqTimeMs(40149, 0, 0));
+    EXPECT_EQ(0, reader.GetUidCpuFreqTimeMs(40000, 0, 0));
+
+    // Rows in the same place as before need no lookup
+    WriteSyntheticCpuProcFiles(40050, 100, 30);
+    EXPECT_TRUE(reader.UpdateCpuTime());
+    result.clear();
+    reader.DumpReadInfo(result);
+    EXPECT_NE(std::string::npos, result.find("new uid rows=0"));
+    EXPECT_EQ(200, reader.GetUidCpuFreqTimeMs(40050, 0, 0));
+
+    RemoveCpuProcFiles();
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_029 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_030
+ * @tc.desc: test the cpu time reader skips the uid rows that did not change since the last sample
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_030, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_030 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    CpuTimeReader reader;
+    reader.SetProcRoot(TEST_PROC_ROOT);
+    statsService->SetOnBattery(false);
+    WriteSyntheticCpuProcFiles(50000, 100, 10);
+    EXPECT_TRUE(reader.UpdateCpuTime());
+
+    statsService->SetOnBattery(true);
+    EXPECT_TRUE(reader.UpdateCpuTime());
+    std::string result;
+    reader.DumpReadInfo(result);
+    EXPECT_NE(std::string::npos, result.find("unchanged uid rows=400/400"));
+    EXPECT_EQ(0, reader.GetUidCpuFreqTimeMs(50000, 0, 0));
+
+    WriteSyntheticCpuProcFiles(50000, 100, 20);
+    EXPECT_TRUE(reader.UpdateCpuTime());
+    result.clear();
+    reader.DumpReadInfo(result);
+    EXPECT_NE(std::string::npos, result.find("unchanged uid rows=0/400"));
+    EXPECT_EQ(100, reader.GetUidCpuFreqTimeMs(50099, 0, 0));
+
+    RemoveCpuProcFiles();
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_030 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_031
+ * @tc.desc: test the cpu time reader weights the active and cluster time by the number of cpus active
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_031, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_031 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto parser = statsService->GetBatteryStatsParser();
+    std::vector<uint16_t> speedNums;
+    for (uint16_t i = 0; i < parser->GetClusterNum(); i++) {
+        speedNums.push_back(parser->GetSpeedNum(i));
+    }
+    // Two cores per cluster, every time field at 12 units of 10ms
+    uint16_t coresPerCluster = 2;
+    CpuProcGenerator generator(TEST_PROC_ROOT, speedNums, coresPerCluster);
+    CpuTimeReader reader;
+    reader.SetProcRoot(TEST_PROC_ROOT);
+    statsService->SetOnBattery(true);
+    ASSERT_TRUE(generator.Write(60000, 1, 12));
+    EXPECT_TRUE(reader.UpdateCpuTime());
+
+    size_t cpuCount = speedNums.size() * coresPerCluster;
+    double weightedTime = 0.0;
+    for (size_t i = 0; i < cpuCount; i++) {
+        weightedTime += 12.0 * (1.0 / static_cast<double>(i + 1));
+    }
+    EXPECT_EQ(static_cast<int64_t>(cpuCount) * 120, reader.GetUidCpuActiveTimeMs(60000));
+    EXPECT_EQ(static_cast<int64_t>(weightedTime * 10), reader.GetUidCpuWeightedActiveTimeMs(60000));
+    EXPECT_EQ(240, reader.GetUidCpuClusterTimeMs(60000, 0));
+    EXPECT_EQ(180, reader.GetUidCpuWeightedClusterTimeMs(60000, 0));
+
+    std::string result;
+    reader.DumpInfo(result, 60000);
+    EXPECT_NE(std::string::npos, result.find("concurrency weighted="));
+
+    // Shared accounting charges the weighted active and cluster time instead of the raw one
+    CpuEntity cpuEntity;
+    cpuEntity.SetProcRoot(TEST_PROC_ROOT);
+    cpuEntity.UpdateCpuTime();
+    cpuEntity.Calculate();
+    double exclusivePowerMah = cpuEntity.GetEntityPowerMah(60000);
+    statsService->GetBatteryStatsCore()->SetAccountingMode(StatsTimerStore::ACCOUNTING_SHARED);
+    cpuEntity.Calculate();
+    double sharedPowerMah = cpuEntity.GetEntityPowerMah(60000);
+    statsService->GetBatteryStatsCore()->SetAccountingMode(StatsTimerStore::ACCOUNTING_EXCLUSIVE);
+    double weightedTimeMah = parser->GetCpuActiveCoefficientMa() *
+        (reader.GetUidCpuActiveTimeMs(60000) - reader.GetUidCpuWeightedActiveTimeMs(60000));
+    const auto& clusterCoefficients = parser->GetCpuClusterCoefficientsMa();
+    for (uint32_t i = 0; i < clusterCoefficients.size(); i++) {
+        weightedTimeMah += clusterCoefficients[i] *
+            (reader.GetUidCpuClusterTimeMs(60000, i) - reader.GetUidCpuWeightedClusterTimeMs(60000, i));
+    }
+    EXPECT_NEAR(weightedTimeMah / StatsUtils::MS_IN_HOUR, exclusivePowerMah - sharedPowerMah, 1e-9);
+
+    generator.Remove();
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_031 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_032
+ * @tc.desc: test the uid cpu files present while the active time file is missing are still merged
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_032, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_032 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    statsService->SetOnBattery(true);
+    CpuTimeReader reader;
+    reader.SetProcRoot(TEST_PROC_ROOT);
+    WriteSyntheticCpuProcFiles(61000, 1, 10);
+    std::remove((TEST_PROC_ROOT + "/uid_concurrent_active_time").c_str());
+    EXPECT_TRUE(reader.UpdateCpuTime());
+    // Only the active time comes from the pid files, which hold no process here
+    EXPECT_EQ(100, reader.GetUidCpuClusterTimeMs(61000, 0));
+    EXPECT_EQ(100, reader.GetUidCpuFreqTimeMs(61000, 0, 0));
+    EXPECT_EQ(2u, reader.GetUidCpuTimeMs(61000).size());
+    EXPECT_EQ(StatsUtils::DEFAULT_VALUE, reader.GetUidCpuActiveTimeMs(61000));
+
+    // The other files were merged, their rows are unchanged once the active time file is back
+    WriteSyntheticCpuProcFiles(61000, 1, 10);
+    EXPECT_TRUE(reader.UpdateCpuTime());
+    EXPECT_EQ(100, reader.GetUidCpuClusterTimeMs(61000, 0));
+    EXPECT_GT(reader.GetUidCpuActiveTimeMs(61000), StatsUtils::DEFAULT_VALUE);
+
+    std::string result;
+    reader.DumpReadInfo(result);
+    EXPECT_NE(std::string::npos, result.find("unchanged uid rows=3/4"));
+
+    RemoveCpuProcFiles();
+    statsService->SetOnBattery(false);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_032 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_033
+ * @tc.desc: test computing power does not wait for a cpu sample already in flight
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_033, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_033 start");
+    // Two samples fit in the wait of a transition
+    int32_t sampleCostUs = SERVICE_POWER_CONSUMPTION_DURATION_US / 4;
+    StatsCpuSampler sampler([sampleCostUs] { usleep(sampleCostUs); });
+    sampler.Start();
+    sampler.RequestSample(StatsCpuSampler::TRIGGER_SCREEN);
+    usleep(sampleCostUs / 10);
+
+    // The screen sample is still running, the compute goes on with the last sample
+    auto begin = std::chrono::steady_clock::now();
+    EXPECT_FALSE(sampler.SampleNow(StatsCpuSampler::TRIGGER_COMPUTE, StatsCpuSampler::COMPUTE_MIN_AGE_MS));
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    EXPECT_LT(elapsedMs, StatsCpuSampler::SAMPLE_WAIT_MS / 10);
+    EXPECT_EQ(0u, sampler.GetSampleCount(StatsCpuSampler::TRIGGER_COMPUTE));
+
+    // A transition still waits for its own sample
+    EXPECT_TRUE(sampler.SampleNow(StatsCpuSampler::TRIGGER_BATTERY));
+    EXPECT_EQ(1u, sampler.GetSampleCount(StatsCpuSampler::TRIGGER_BATTERY));
+    std::string result;
+    sampler.DumpInfo(result);
+    EXPECT_NE(std::string::npos, result.find("in flight skipped=1"));
+    sampler.Stop();
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_033 end");
+}
 }
\ No newline at end of file
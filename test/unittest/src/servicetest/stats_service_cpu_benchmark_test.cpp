@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_service_cpu_benchmark_test.h"
+#include "stats_log.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "battery_stats_parser.h"
+#include "battery_stats_service.h"
+#include "cpu_proc_generator.h"
+#include "entities/cpu_entity.h"
+#include "stats_utils.h"
+
+using namespace OHOS;
+using namespace OHOS::PowerMgr;
+using namespace std;
+using namespace testing::ext;
+
+namespace {
+static sptr<BatteryStatsService> g_statsService = nullptr;
+static const std::string BENCHMARK_PROC_ROOT = "/data/local/tmp/stats_cpu_benchmark";
+constexpr int32_t BENCHMARK_FIRST_UID = 20000;
+constexpr int32_t BENCHMARK_ITERATIONS = 20;
+constexpr double BENCHMARK_CLUSTER_MA = 10.0;
+constexpr double BENCHMARK_SPEED_MA = 50.0;
+
+// Swaps the cpu layout of the power profile for the given one, the profile layout is restored on destruction
+class ScopedCpuLayout {
+public:
+    ScopedCpuLayout(const std::shared_ptr<BatteryStatsParser>& parser, const std::vector<uint16_t>& speedNums)
+        : parser_(parser), clusterNum_(parser->clusterNum_), speedNum_(parser->speedNum_),
+        averageVecMap_(parser->averageVecMap_)
+    {
+        parser_->clusterNum_ = static_cast<uint16_t>(speedNums.size());
+        parser_->speedNum_ = speedNums;
+        parser_->averageVecMap_[StatsUtils::CURRENT_CPU_CLUSTER] =
+            std::vector<double>(speedNums.size(), BENCHMARK_CLUSTER_MA);
+        for (size_t i = 0; i < speedNums.size(); i++) {
+            parser_->averageVecMap_[StatsUtils::CURRENT_CPU_SPEED + std::to_string(i)] =
+                std::vector<double>(speedNums[i], BENCHMARK_SPEED_MA);
+        }
+        parser_->BuildCpuCoefficients();
+    }
+
+    ~ScopedCpuLayout()
+    {
+        parser_->clusterNum_ = clusterNum_;
+        parser_->speedNum_ = speedNum_;
+        parser_->averageVecMap_ = averageVecMap_;
+        parser_->BuildCpuCoefficients();
+    }
+
+private:
+    std::shared_ptr<BatteryStatsParser> parser_;
+    uint16_t clusterNum_;
+    std::vector<uint16_t> speedNum_;
+    std::map<std::string, std::vector<double>> averageVecMap_;
+};
+
+// Average time of one cpu time update and one cpu power calculation over uidCount uids with the given layout
+void RunCpuBenchmark(int32_t uidCount, const std::vector<uint16_t>& speedNums)
+{
+    auto statsService = BatteryStatsService::GetInstance();
+    ScopedCpuLayout layout(statsService->GetBatteryStatsParser(), speedNums);
+    CpuProcGenerator generator(BENCHMARK_PROC_ROOT, speedNums, 1);
+    CpuEntity cpuEntity;
+    cpuEntity.SetProcRoot(BENCHMARK_PROC_ROOT);
+    statsService->SetOnBattery(false);
+    ASSERT_TRUE(generator.Write(BENCHMARK_FIRST_UID, uidCount, 10));
+    cpuEntity.UpdateCpuTime();
+    statsService->SetOnBattery(true);
+
+    int64_t updateTimeUs = 0;
+    int64_t calculateTimeUs = 0;
+    for (int32_t i = 1; i <= BENCHMARK_ITERATIONS; i++) {
+        // Every sample has new time for every uid, the worst case for the delta computation
+        ASSERT_TRUE(generator.Write(BENCHMARK_FIRST_UID, uidCount, 10 + i));
+        auto begin = std::chrono::steady_clock::now();
+        cpuEntity.UpdateCpuTime();
+        auto updated = std::chrono::steady_clock::now();
+        cpuEntity.Calculate();
+        auto calculated = std::chrono::steady_clock::now();
+        updateTimeUs += std::chrono::duration_cast<std::chrono::microseconds>(updated - begin).count();
+        calculateTimeUs += std::chrono::duration_cast<std::chrono::microseconds>(calculated - updated).count();
+    }
+    GTEST_LOG_(INFO) << "cpu benchmark of " << uidCount << " uids, " << speedNums.size() << " clusters, " <<
+        (speedNums.empty() ? 0 : speedNums[0]) << " speeds per cluster: update " <<
+        updateTimeUs / BENCHMARK_ITERATIONS << "us, calculate " << calculateTimeUs / BENCHMARK_ITERATIONS << "us";
+    EXPECT_GT(cpuEntity.GetCpuTimeMs(BENCHMARK_FIRST_UID + uidCount - 1), 0);
+    EXPECT_GT(cpuEntity.GetEntityPowerMah(BENCHMARK_FIRST_UID + uidCount - 1), 0);
+
+    statsService->SetOnBattery(false);
+    generator.Remove();
+}
+} // namespace
+
+void StatsServiceCpuBenchmarkTest::SetUpTestCase()
+{
+    g_statsService = BatteryStatsService::GetInstance();
+    g_statsService->OnStart();
+}
+
+void StatsServiceCpuBenchmarkTest::TearDownTestCase()
+{
+    g_statsService->OnStop();
+}
+
+void StatsServiceCpuBenchmarkTest::SetUp()
+{
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    statsCore->Reset();
+}
+
+void StatsServiceCpuBenchmarkTest::TearDown()
+{
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    statsCore->Reset();
+}
+
+namespace {
+/**
+ * @tc.name: StatsServiceCpuBenchmarkTest_001
+ * @tc.desc: test the time of the cpu time update and power calculation with 1000 uids on 1 cluster of 8 speeds
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCpuBenchmarkTest, StatsServiceCpuBenchmarkTest_001, TestSize.Level3)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCpuBenchmarkTest_001 start");
+    RunCpuBenchmark(1000, CpuProcGenerator::GetUniformSpeedNums(1, 8));
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCpuBenchmarkTest_001 end");
+}
+
+/**
+ * @tc.name: StatsServiceCpuBenchmarkTest_002
+ * @tc.desc: test the time of the cpu time update and power calculation with 1000 uids on 3 clusters of 16 speeds
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCpuBenchmarkTest, StatsServiceCpuBenchmarkTest_002, TestSize.Level3)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCpuBenchmarkTest_002 start");
+    RunCpuBenchmark(1000, CpuProcGenerator::GetUniformSpeedNums(3, 16));
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCpuBenchmarkTest_002 end");
+}
+
+/**
+ * @tc.name: StatsServiceCpuBenchmarkTest_003
+ * @tc.desc: test the time of the cpu time update and power calculation with 10000 uids on 1 cluster of 8 speeds
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCpuBenchmarkTest, StatsServiceCpuBenchmarkTest_003, TestSize.Level3)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCpuBenchmarkTest_003 start");
+    RunCpuBenchmark(10000, CpuProcGenerator::GetUniformSpeedNums(1, 8));
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCpuBenchmarkTest_003 end");
+}
+
+/**
+ * @tc.name: StatsServiceCpuBenchmarkTest_004
+ * @tc.desc: test the time of the cpu time update and power calculation with 10000 uids on 3 clusters of 16 speeds
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCpuBenchmarkTest, StatsServiceCpuBenchmarkTest_004, TestSize.Level3)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCpuBenchmarkTest_004 start");
+    RunCpuBenchmark(10000, CpuProcGenerator::GetUniformSpeedNums(3, 16));
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCpuBenchmarkTest_004 end");
+}
+}
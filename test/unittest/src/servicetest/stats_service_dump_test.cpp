@@ -511,4 +511,31 @@ HWTEST_F (StatsServiceDumpTest, StatsServiceDumpTest_009, TestSize.Level0)
     EXPECT_TRUE(helpIndex != string::npos);
     STATS_HILOGI(LABEL_TEST, "StatsServiceDumpTest_009 end");
 }
+
+/**
+ * @tc.name: StatsServiceDumpTest_010
+ * @tc.desc: test Dump function(switch the parallel read of the cpu time)
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceDumpTest, StatsServiceDumpTest_010, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceDumpTest_010 start");
+    ASSERT_NE(g_statsServiceProxy, nullptr);
+
+    std::vector<std::string> dumpArgs;
+    dumpArgs.push_back("-cpuparallel");
+    dumpArgs.push_back("on");
+    std::string actualDebugInfo;
+    g_statsServiceProxy->ShellDumpIpc(dumpArgs, dumpArgs.size(), actualDebugInfo);
+    EXPECT_TRUE(actualDebugInfo.find("Cpu parallel read: on") != string::npos);
+
+    dumpArgs[1] = "off";
+    g_statsServiceProxy->ShellDumpIpc(dumpArgs, dumpArgs.size(), actualDebugInfo);
+    EXPECT_TRUE(actualDebugInfo.find("Cpu parallel read: off") != string::npos);
+
+    dumpArgs[1] = "maybe";
+    g_statsServiceProxy->ShellDumpIpc(dumpArgs, dumpArgs.size(), actualDebugInfo);
+    EXPECT_TRUE(actualDebugInfo.find("Unknown cpu parallel read switch: maybe") != string::npos);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceDumpTest_010 end");
+}
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpu_proc_generator.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sys/stat.h>
+
+namespace OHOS {
+namespace PowerMgr {
+namespace {
+const std::string ACTIVE_TIME_FILE = "uid_concurrent_active_time";
+const std::string POLICY_TIME_FILE = "uid_concurrent_policy_time";
+const std::string FREQ_TIME_FILE = "uid_time_in_state";
+const std::string UID_TIME_DIR = "uid_cputime";
+const std::string UID_TIME_FILE = "uid_cputime/show_uid_stat";
+}
+
+CpuProcGenerator::CpuProcGenerator(const std::string& procRoot, const std::vector<uint16_t>& speedNums,
+    uint16_t coresPerCluster) : procRoot_(procRoot), speedNums_(speedNums), coresPerCluster_(coresPerCluster)
+{
+}
+
+std::vector<uint16_t> CpuProcGenerator::GetUniformSpeedNums(uint16_t clusterNum, uint16_t speedNum)
+{
+    return std::vector<uint16_t>(clusterNum, speedNum);
+}
+
+bool CpuProcGenerator::Write(int32_t firstUid, int32_t uidCount, int64_t time)
+{
+    std::string value = " " + std::to_string(time);
+    std::string speedTimes;
+    std::string cpuTimes;
+    std::string policyHeader;
+    uint32_t cpuCount = 0;
+    for (size_t i = 0; i < speedNums_.size(); i++) {
+        for (uint16_t j = 0; j < speedNums_[i]; j++) {
+            speedTimes.append(value);
+        }
+        policyHeader.append(i == 0 ? "" : " ").append("policy").append(std::to_string(cpuCount))
+            .append(": ").append(std::to_string(coresPerCluster_));
+        for (uint16_t j = 0; j < coresPerCluster_; j++) {
+            cpuTimes.append(value);
+        }
+        cpuCount += coresPerCluster_;
+    }
+    std::string uidTimes = " " + std::to_string(time * US_PER_MS) + " " + std::to_string(time * US_PER_MS);
+
+    std::string freqContent = "uid:" + speedTimes + "\n";
+    std::string activeContent = "cpus: " + std::to_string(cpuCount) + "\n";
+    std::string policyContent = policyHeader + "\n";
+    std::string uidTimeContent;
+    for (int32_t uid = firstUid; uid < firstUid + uidCount; uid++) {
+        std::string prefix = std::to_string(uid) + ":";
+        freqContent.append(prefix).append(speedTimes).append("\n");
+        activeContent.append(prefix).append(cpuTimes).append("\n");
+        policyContent.append(prefix).append(cpuTimes).append("\n");
+        uidTimeContent.append(prefix).append(uidTimes).append("\n");
+    }
+    mkdir(procRoot_.c_str(), S_IRWXU);
+    mkdir((procRoot_ + "/" + UID_TIME_DIR).c_str(), S_IRWXU);
+    return WriteFile(FREQ_TIME_FILE, freqContent) && WriteFile(ACTIVE_TIME_FILE, activeContent) &&
+        WriteFile(POLICY_TIME_FILE, policyContent) && WriteFile(UID_TIME_FILE, uidTimeContent);
+}
+
+bool CpuProcGenerator::WriteFile(const std::string& name, const std::string& content)
+{
+    std::ofstream file(procRoot_ + "/" + name, std::ios::trunc);
+    file << content;
+    return file.good();
+}
+
+void CpuProcGenerator::Remove()
+{
+    std::remove((procRoot_ + "/" + FREQ_TIME_FILE).c_str());
+    std::remove((procRoot_ + "/" + ACTIVE_TIME_FILE).c_str());
+    std::remove((procRoot_ + "/" + POLICY_TIME_FILE).c_str());
+    std::remove((procRoot_ + "/" + UID_TIME_FILE).c_str());
+}
+} // namespace PowerMgr
+} // namespace OHOS
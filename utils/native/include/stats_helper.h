@@ -28,8 +28,8 @@ public:
     class ActiveTimer {
     public:
         ActiveTimer() = default;
-        ~ActiveTimer() = default;
-        bool StartRunning()
+        virtual ~ActiveTimer() = default;
+        virtual bool StartRunning()
         {
             if (isRunning_) {
                 STATS_HILOGD(COMP_SVC, "Active timer was already started");
@@ -41,7 +41,7 @@ public:
             return true;
         }
 
-        bool StopRunning()
+        virtual bool StopRunning()
         {
             if (!isRunning_) {
                 STATS_HILOGD(COMP_SVC, "No related active timer is running");
@@ -54,7 +54,7 @@ public:
             return true;
         }
 
-        int64_t GetRunningTimeMs()
+        virtual int64_t GetRunningTimeMs()
         {
             if (isRunning_) {
                 auto tmpStopTimeMs = GetOnBatteryBootTimeMs();
@@ -64,7 +64,7 @@ public:
             return totalTimeMs_;
         }
 
-        void AddRunningTimeMs(int64_t avtiveTime)
+        virtual void AddRunningTimeMs(int64_t avtiveTime)
         {
             if (avtiveTime > StatsUtils::DEFAULT_VALUE) {
                 totalTimeMs_ += avtiveTime;
@@ -74,7 +74,7 @@ public:
             }
         }
 
-        void Reset()
+        virtual void Reset()
         {
             isRunning_ = false;
             startTimeMs_ = GetOnBatteryBootTimeMs();
@@ -116,6 +116,7 @@ public:
 
     static std::string ConvertStatsType(StatsType statsType);
     static bool ParseStrtollResult(const std::string& str, int64_t& result);
+    static double DotProduct(const int64_t* times, const double* coefficients, size_t count);
 private:
     static std::string ConvertTypeForConn(StatsType statsType);
     static std::string ConvertTypeForCpu(StatsType statsType);
@@ -212,5 +212,22 @@ bool StatsUtils::ParseStrtollResult(const std::string& str, int64_t& result)
     }
     return true;
 }
+
+double StatsUtils::DotProduct(const int64_t* times, const double* coefficients, size_t count)
+{
+    // Independent partial sums, so the lanes can be vectorized without reassociating one running sum
+    constexpr size_t DOT_PRODUCT_LANES = 4;
+    double sums[DOT_PRODUCT_LANES] = {};
+    size_t i = 0;
+    for (; i + DOT_PRODUCT_LANES <= count; i += DOT_PRODUCT_LANES) {
+        for (size_t lane = 0; lane < DOT_PRODUCT_LANES; lane++) {
+            sums[lane] += static_cast<double>(times[i + lane]) * coefficients[i + lane];
+        }
+    }
+    for (; i < count; i++) {
+        sums[0] += static_cast<double>(times[i]) * coefficients[i];
+    }
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file